@@ -56,6 +56,7 @@ enum DISPLAY3D_FLG {
     FL_RENDER_RAYTRACING_POST_PROCESSING,
     FL_RENDER_RAYTRACING_ANTI_ALIASING,
     FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES,
+    FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER,
     FL_LAST
 };
 
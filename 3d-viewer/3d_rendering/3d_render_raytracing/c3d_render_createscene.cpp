@@ -34,6 +34,7 @@
 #include "shapes3D/clayeritem.h"
 #include "shapes3D/ccylinder.h"
 #include "shapes3D/ctriangle.h"
+#include "shapes3D/cinstance.h"
 #include "shapes2D/citemlayercsg2d.h"
 #include "shapes2D/cring2d.h"
 #include "shapes2D/cpolygon2d.h"
@@ -274,6 +275,9 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     m_object_container.Clear();
     m_containerWithObjectsToDelete.Clear();
 
+    // The instances that were in the object container are already gone
+    delete_model_accelerators();
+
 
     // Create and add the outline board
     // /////////////////////////////////////////////////////////////////////////
@@ -1194,6 +1198,12 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // All the placements are collected first, so models that are used more than
+    // once (e.g. the same passive package all over the board) are converted to
+    // triangles only once and then instanced.
+    std::vector< std::pair< const S3DMODEL *, glm::mat4 > > placements;
+    std::map< const S3DMODEL *, unsigned int > useCount;
+
     // Go for all modules
     for( auto module : m_settings.GetBoard()->Modules() )
     {
@@ -1280,18 +1290,74 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
                                                        sM->m_Scale.y,
                                                        sM->m_Scale.z ) );
 
-                    add_3D_models( modelPtr, modelMatrix );
+                    placements.push_back( std::make_pair( modelPtr, modelMatrix ) );
+                    useCount[modelPtr]++;
                 }
 
                 ++sM;
             }
         }
     }
+
+    for( const auto& placement : placements )
+    {
+        const S3DMODEL *modelPtr = placement.first;
+        const glm::mat4 &modelMatrix = placement.second;
+
+        // A mirroring matrix would reverse the triangles winding as seen by the
+        // shared model space triangles, so those are still baked in world space.
+        if( ( useCount[modelPtr] > 1 ) &&
+            ( glm::determinant( glm::mat3( modelMatrix ) ) > 0.0f ) )
+            add_3D_model_instance( modelPtr, modelMatrix );
+        else
+            add_3D_models( modelPtr, modelMatrix, m_object_container );
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::add_3D_model_instance( const S3DMODEL *a3DModel,
+                                                   const glm::mat4 &aModelMatrix )
+{
+    auto it = m_model_accelerators.find( a3DModel );
+
+    if( it == m_model_accelerators.end() )
+    {
+        MODEL_ACCELERATOR modelAcc;
+
+        modelAcc.m_triangles = new CCONTAINER;
+
+        add_3D_models( a3DModel, glm::mat4( 1.0f ), *modelAcc.m_triangles );
+
+        modelAcc.m_accelerator = modelAcc.m_triangles->GetList().empty() ?
+                                 NULL : new CBVH_PBRT( *modelAcc.m_triangles );
+
+        it = m_model_accelerators.insert( std::make_pair( a3DModel, modelAcc ) ).first;
+    }
+
+    const MODEL_ACCELERATOR &modelAcc = it->second;
+
+    if( modelAcc.m_accelerator )
+        m_object_container.Add( new CINSTANCE( modelAcc.m_accelerator,
+                                               modelAcc.m_triangles->GetBBox(),
+                                               aModelMatrix ) );
+}
+
+
+void C3D_RENDER_RAYTRACING::delete_model_accelerators()
+{
+    for( auto& modelAcc : m_model_accelerators )
+    {
+        delete modelAcc.second.m_accelerator;
+        delete modelAcc.second.m_triangles;
+    }
+
+    m_model_accelerators.clear();
 }
 
 
 void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
-                                           const glm::mat4 &aModelMatrix )
+                                           const glm::mat4 &aModelMatrix,
+                                           CCONTAINER &aDstContainer )
 {
 
     // Validate a3DModel pointers
@@ -1502,7 +1568,7 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
 
 
 
-                        m_object_container.Add( newTriangle );
+                        aDstContainer.Add( newTriangle );
                         newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
 
                         if( mesh.m_Color == NULL )
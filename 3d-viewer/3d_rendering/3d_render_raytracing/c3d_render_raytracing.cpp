@@ -82,6 +82,8 @@ C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
     delete m_accelerator;
     m_accelerator = NULL;
 
+    delete_model_accelerators();
+
     delete m_outlineBoard2dObjects;
     m_outlineBoard2dObjects = NULL;
 
@@ -323,6 +325,16 @@ void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextRepor
                 tmp_ptrPBO += 4;                // PBO is RGBA
             }
         }
+        else if( m_settings.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER ) &&
+                 !m_isPreview )
+        {
+            // Progressive render: show first a coarse image of the full view,
+            // it will be refined block by block by the tracing state.
+            // If the last frame was a preview (e.g. the camera was moving) it is
+            // already on the buffer.
+            // /////////////////////////////////////////////////////////////////////
+            render_preview( ptrPBO );
+        }
 
         m_BgColorTop_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_settings.m_BgColorTop );
         m_BgColorBot_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_settings.m_BgColorBot );
@@ -532,6 +544,7 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
                                                 const HITINFO_PACKET *aHitPck_X0Y0,
                                                 const HITINFO_PACKET *aHitPck_AA_X1Y1,
                                                 const RAY *aRayPck,
+                                                const bool *aPixelNeedsAA,
                                                 SFVEC3F *aOutHitColor )
 {
     const bool is_testShadow =  m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
@@ -540,6 +553,10 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
     {
         for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
+            // Keep the average color of the first samples on smooth regions
+            if( !aPixelNeedsAA[i] )
+                continue;
+
             const RAY &rayAA = aRayPck[i];
 
             HITINFO hitAA;
@@ -655,6 +672,140 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 
 #define DISP_FACTOR 0.075f
 
+/// Minimum color difference (on any channel, linear RGB) between the first
+/// samples of a pixel, or between it and its neighbours, to trace the
+/// remaining anti-aliasing rays for that pixel
+#define AA_ADAPTIVE_THRESHOLD 0.02f
+
+
+static inline float colorDifference( const SFVEC3F &aA, const SFVEC3F &aB )
+{
+    const SFVEC3F d = glm::abs( aA - aB );
+
+    return glm::max( d.r, glm::max( d.g, d.b ) );
+}
+
+
+/**
+ * Function markPixelsToRefine
+ * selects the pixels of a packet that are on edges or on noisy regions, where the
+ * two first samples differ or the pixel differs from any of its neighbours in the
+ * packet. Both pixels of an edge are selected.
+ * @return true if any pixel needs more samples
+ */
+static bool markPixelsToRefine( const SFVEC3F *aColor_X0Y0,
+                                const SFVEC3F *aColor_AA_X1Y1,
+                                bool *aOutPixelNeedsAA )
+{
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        aOutPixelNeedsAA[i] = colorDifference( aColor_X0Y0[i],
+                                               aColor_AA_X1Y1[i] ) > AA_ADAPTIVE_THRESHOLD;
+
+    // Comparing each pixel with its right and bottom neighbours, and marking both
+    // of them, covers the four neighbours of every pixel
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+        {
+            if( ( x < (RAYPACKET_DIM - 1) ) &&
+                ( colorDifference( aColor_X0Y0[i], aColor_X0Y0[i + 1] ) > AA_ADAPTIVE_THRESHOLD ) )
+            {
+                aOutPixelNeedsAA[i] = true;
+                aOutPixelNeedsAA[i + 1] = true;
+            }
+
+            if( ( y < (RAYPACKET_DIM - 1) ) &&
+                ( colorDifference( aColor_X0Y0[i],
+                                   aColor_X0Y0[i + RAYPACKET_DIM] ) > AA_ADAPTIVE_THRESHOLD ) )
+            {
+                aOutPixelNeedsAA[i] = true;
+                aOutPixelNeedsAA[i + RAYPACKET_DIM] = true;
+            }
+        }
+    }
+
+    bool anyNeedsAA = false;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        anyNeedsAA |= aOutPixelNeedsAA[i];
+
+    return anyNeedsAA;
+}
+
+
+/**
+ * Function rt_mark_packet_border
+ * selects the pixels on the border of a packet that differ from their neighbour in
+ * the next packet. The neighbours are traced as a one pixel apron around the packet,
+ * only for the border pixels not already selected. The next packet selects its own
+ * side of the edge the same way.
+ * @return true if any pixel was selected
+ */
+bool C3D_RENDER_RAYTRACING::rt_mark_packet_border( const SFVEC2I &aBlockPosI,
+                                                    const SFVEC3F *aColor_X0Y0,
+                                                    bool *aPixelNeedsAA )
+{
+    const bool is_testShadow = m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
+
+    // Position of the outside neighbour for the left, right, top and bottom borders
+    const int neighbourX[4] = { -1, 1, 0, 0 };
+    const int neighbourY[4] = { 0, 0, -1, 1 };
+
+    bool anyNeedsAA = false;
+
+    for( unsigned int side = 0; side < 4; ++side )
+    {
+        for( unsigned int j = 0; j < RAYPACKET_DIM; ++j )
+        {
+            const unsigned int x = ( side == 0 ) ? 0 : ( side == 1 ) ? ( RAYPACKET_DIM - 1 ) : j;
+            const unsigned int y = ( side == 2 ) ? 0 : ( side == 3 ) ? ( RAYPACKET_DIM - 1 ) : j;
+            const unsigned int i = x + y * RAYPACKET_DIM;
+
+            if( aPixelNeedsAA[i] )
+                continue;
+
+            const int nx = aBlockPosI.x + (int)x + neighbourX[side];
+            const int ny = aBlockPosI.y + (int)y + neighbourY[side];
+
+            if( ( nx < 0 ) || ( ny < 0 ) || ( nx >= m_windowSize.x ) || ( ny >= m_windowSize.y ) )
+                continue;
+
+            const float posYfactor = (float)ny / (float)m_windowSize.y;
+
+            const SFVEC3F bgColor = m_BgColorTop_LinearRGB * SFVEC3F(posYfactor) +
+                                    m_BgColorBot_LinearRGB * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
+
+            SFVEC3F rayOrigin;
+            SFVEC3F rayDir;
+
+            m_settings.CameraGet().MakeRay( SFVEC2F( (float)nx + DISP_FACTOR,
+                                                     (float)ny + DISP_FACTOR ),
+                                            rayOrigin, rayDir );
+
+            RAY ray;
+            ray.Init( rayOrigin, rayDir );
+
+            HITINFO hit;
+            hit.m_tHit = std::numeric_limits<float>::infinity();
+            hit.m_acc_node_info = 0;
+
+            SFVEC3F neighbourColor = bgColor;
+
+            if( m_accelerator->Intersect( ray, hit ) )
+                neighbourColor = shadeHit( bgColor, ray, hit, false, 0, is_testShadow );
+
+            if( colorDifference( aColor_X0Y0[i], neighbourColor ) > AA_ADAPTIVE_THRESHOLD )
+            {
+                aPixelNeedsAA[i] = true;
+                anyNeedsAA = true;
+            }
+        }
+    }
+
+    return anyNeedsAA;
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                                                    signed int iBlock )
 {
@@ -788,6 +939,17 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                               );
         }
 
+        // Adaptive sampling: the remaining anti-aliasing rays are only traced
+        // for the pixels that are not on a smooth region
+        // /////////////////////////////////////////////////////////////////////////
+        bool pixelNeedsAA[RAYPACKET_RAYS_PER_PACKET];
+
+        bool anyNeedsAA = markPixelsToRefine( hitColor_X0Y0,
+                                              hitColor_AA_X1Y1,
+                                              pixelNeedsAA );
+
+        anyNeedsAA |= rt_mark_packet_border( blockPosI, hitColor_X0Y0, pixelNeedsAA );
+
         SFVEC3F hitColor_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
         SFVEC3F hitColor_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
         SFVEC3F hitColor_AA_X0Y1_half[RAYPACKET_RAYS_PER_PACKET];
@@ -802,39 +964,45 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
             hitColor_AA_X0Y1_half[i] = color_average;
         }
 
-        RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(0.5f - DISP_FACTOR, DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X1Y0 );
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(DISP_FACTOR, 0.5f - DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X0Y1 );
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X1Y1_half );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X1Y0,
-                            hitColor_AA_X1Y0 );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X0Y1,
-                            hitColor_AA_X0Y1 );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X1Y1_half,
-                            hitColor_AA_X0Y1_half );
+        if( anyNeedsAA )
+        {
+            RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(0.5f - DISP_FACTOR, DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X1Y0 );
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(DISP_FACTOR, 0.5f - DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X0Y1 );
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X1Y1_half );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X1Y0,
+                                pixelNeedsAA,
+                                hitColor_AA_X1Y0 );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X0Y1,
+                                pixelNeedsAA,
+                                hitColor_AA_X0Y1 );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X1Y1_half,
+                                pixelNeedsAA,
+                                hitColor_AA_X0Y1_half );
+        }
 
         // Average the result
         for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
@@ -47,6 +47,17 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+/// Triangles of a 3D model in its own space and the accelerator built over them,
+/// shared by all the instances of that model in the scene
+struct MODEL_ACCELERATOR
+{
+    CCONTAINER          *m_triangles;
+    CGENERICACCELERATOR *m_accelerator;
+};
+
+/// Maps a S3DMODEL pointer with its shared MODEL_ACCELERATOR
+typedef std::map< const S3DMODEL * , MODEL_ACCELERATOR > MAP_MODEL_ACCELERATORS;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -93,8 +104,13 @@ private:
                              const HITINFO_PACKET *aHitPck_X0Y0,
                              const HITINFO_PACKET *aHitPck_AA_X1Y1,
                              const RAY *aRayPck,
+                             const bool *aPixelNeedsAA,
                              SFVEC3F *aOutHitColor );
 
+    bool rt_mark_packet_border( const SFVEC2I &aBlockPosI,
+                                const SFVEC3F *aColor_X0Y0,
+                                bool *aPixelNeedsAA );
+
     // Materials
     void setupMaterials();
 
@@ -196,11 +212,18 @@ private:
     void insert3DPadHole( const D_PAD* aPad );
     void load_3D_models();
     void add_3D_models( const S3DMODEL *a3DModel,
-                        const glm::mat4 &aModelMatrix );
+                        const glm::mat4 &aModelMatrix,
+                        CCONTAINER &aDstContainer );
+    void add_3D_model_instance( const S3DMODEL *a3DModel,
+                                const glm::mat4 &aModelMatrix );
+    void delete_model_accelerators();
 
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
 
+    /// Stores the accelerators of the 3D models that are placed more than once
+    MAP_MODEL_ACCELERATORS m_model_accelerators;
+
     void initialize_block_positions();
 
     void render( GLubyte *ptrPBO, REPORTER *aStatusTextReporter );
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.cpp
+ * @brief
+ */
+
+#include "cinstance.h"
+#include "../accelerators/caccelerator.h"
+
+
+CINSTANCE::CINSTANCE( const CGENERICACCELERATOR *aModel,
+                      const CBBOX &aModelBBox,
+                      const glm::mat4 &aModelMatrix ) : COBJECT( OBJ3D_INSTANCE )
+{
+    m_model          = aModel;
+    m_invModelMatrix = glm::inverse( aModelMatrix );
+    m_normalMatrix   = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+
+    // The world bounding box encloses the 8 transformed corners of the model one
+    const SFVEC3F &bmin = aModelBBox.Min();
+    const SFVEC3F &bmax = aModelBBox.Max();
+
+    m_bbox.Reset();
+
+    for( unsigned int i = 0; i < 8; ++i )
+    {
+        const SFVEC3F corner( (i & 1) ? bmax.x : bmin.x,
+                              (i & 2) ? bmax.y : bmin.y,
+                              (i & 4) ? bmax.z : bmin.z );
+
+        m_bbox.Union( SFVEC3F( aModelMatrix * glm::vec4( corner, 1.0f ) ) );
+    }
+
+    m_bbox.ScaleNextUp();
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+void CINSTANCE::toModelSpace( const RAY &aRay, RAY &aModelRay ) const
+{
+    // The direction is not normalized so the ray parameter t is the same in
+    // both spaces and can be compared with the other world objects hits.
+    aModelRay.Init( SFVEC3F( m_invModelMatrix * glm::vec4( aRay.m_Origin, 1.0f ) ),
+                    glm::mat3( m_invModelMatrix ) * aRay.m_Dir );
+}
+
+
+bool CINSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    RAY modelRay;
+
+    toModelSpace( aRay, modelRay );
+
+    // The model accelerator will overwrite the node information of the top
+    // level one, which is used later for the anti-aliasing rays.
+    const unsigned int accNodeInfo = aHitInfo.m_acc_node_info;
+
+    if( m_model->Intersect( modelRay, aHitInfo ) )
+    {
+        aHitInfo.m_acc_node_info = accNodeInfo;
+        aHitInfo.m_HitPoint  = aRay.at( aHitInfo.m_tHit );
+        aHitInfo.m_HitNormal = glm::normalize( m_normalMatrix * aHitInfo.m_HitNormal );
+
+        return true;
+    }
+
+    return false;
+}
+
+
+bool CINSTANCE::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    RAY modelRay;
+
+    toModelSpace( aRay, modelRay );
+
+    return m_model->IntersectP( modelRay, aMaxDistance );
+}
+
+
+bool CINSTANCE::Intersects( const CBBOX &aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F CINSTANCE::GetDiffuseColor( const HITINFO &aHitInfo ) const
+{
+    // Never used: the hit object is always the model triangle
+    (void)aHitInfo;
+
+    return SFVEC3F( 0.0f );
+}
@@ -0,0 +1,72 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cinstance.h
+ * @brief Places a shared, already built accelerator in the scene using a
+ * model transformation, so repeated 3D models only store their triangles once.
+ */
+
+#ifndef _CINSTANCE_H_
+#define _CINSTANCE_H_
+
+#include "cobject.h"
+
+class CGENERICACCELERATOR;
+
+/**
+ * An instance of a model accelerator (bottom level structure).
+ * Rays are transformed to the model space and intersected against the shared
+ * structure. The hit object reported is the model triangle, so materials and
+ * colors are taken from it and not from the instance.
+ */
+class  CINSTANCE : public COBJECT
+{
+
+public:
+    /**
+     * @param aModel - accelerator built in model space, owned by the caller
+     * @param aModelBBox - bounding box of the objects in aModel, in model space
+     * @param aModelMatrix - transformation from model space to world space
+     */
+    CINSTANCE( const CGENERICACCELERATOR *aModel,
+               const CBBOX &aModelBBox,
+               const glm::mat4 &aModelMatrix );
+
+// Imported from COBJECT
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
+    bool Intersects( const CBBOX &aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
+
+private:
+    void toModelSpace( const RAY &aRay, RAY &aModelRay ) const;
+
+private:
+    const CGENERICACCELERATOR *m_model;
+    glm::mat4 m_invModelMatrix;         ///< world to model space
+    glm::mat3 m_normalMatrix;           ///< model to world space, for normals
+};
+
+
+#endif // _CINSTANCE_H_
@@ -163,6 +163,9 @@ void EDA_3D_VIEWER::CreateMenuBar()
     auto postProcessCondition = [ this ] ( const SELECTION& aSel ) {
         return m_settings.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
     };
+    auto progressiveRenderCondition = [ this ] ( const SELECTION& aSel ) {
+        return m_settings.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER );
+    };
     auto showAxesCondition = [ this ] ( const SELECTION& aSel ) {
         return m_settings.GetFlag( FL_AXIS );
     };
@@ -248,6 +251,11 @@ void EDA_3D_VIEWER::CreateMenuBar()
                  _( "Apply Screen Space Ambient Occlusion and Global Illumination reflections on final render (slow)"),
                    green_xpm,                                  postProcessCondition );
 
+    raySubmenu->AddCheckItem( ID_MENU3D_FL_RAYTRACING_PROGRESSIVE_RENDER,
+                 _( "Progressive Rendering" ),
+                 _( "Show a coarse image of the whole view first and refine it while rendering"),
+                   green_xpm,                                  progressiveRenderCondition );
+
     optsSubmenu->AddMenu( raySubmenu,                          SELECTION_CONDITIONS::ShowAlways );
     prefsMenu->AddMenu( optsSubmenu,                           SELECTION_CONDITIONS::ShowAlways );
 
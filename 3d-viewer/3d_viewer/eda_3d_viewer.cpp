@@ -94,6 +94,7 @@ static const wxChar keyRenderRAY_Reflections[]  = wxT( "Render_RAY_Reflections"
 static const wxChar keyRenderRAY_PostProcess[]  = wxT( "Render_RAY_PostProcess" );
 static const wxChar keyRenderRAY_AAliasing[]    = wxT( "Render_RAY_AntiAliasing" );
 static const wxChar keyRenderRAY_ProceduralT[]  = wxT( "Render_RAY_ProceduralTextures" );
+static const wxChar keyRenderRAY_Progressive[]  = wxT( "Render_RAY_ProgressiveRender" );
 
 static const wxChar keyShowAxis[]               = wxT( "ShowAxis" );
 static const wxChar keyShowGrid[]               = wxT( "ShowGrid3D" );
@@ -475,6 +476,11 @@ void EDA_3D_VIEWER::Process_Special_Functions( wxCommandEvent &event )
         m_canvas->Request_refresh();
         return;
 
+    case ID_MENU3D_FL_RAYTRACING_PROGRESSIVE_RENDER:
+        m_settings.SetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER, isChecked );
+        m_canvas->Request_refresh();
+        return;
+
     case ID_MENU3D_SHOW_BOARD_BODY:
         m_settings.SetFlag( FL_SHOW_BOARD_BODY, isChecked );
         NewDisplay( true );
@@ -749,6 +755,9 @@ void EDA_3D_VIEWER::LoadSettings( wxConfigBase *aCfg )
     aCfg->Read( keyRenderRAY_ProceduralT, &tmp, true );
     m_settings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, tmp );
 
+    aCfg->Read( keyRenderRAY_Progressive, &tmp, true );
+    m_settings.SetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER, tmp );
+
     aCfg->Read( keyShowAxis, &tmp, true );
     m_settings.SetFlag( FL_AXIS, tmp );
 
@@ -855,6 +864,7 @@ void EDA_3D_VIEWER::SaveSettings( wxConfigBase *aCfg )
     aCfg->Write( keyRenderRAY_PostProcess,  m_settings.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) );
     aCfg->Write( keyRenderRAY_AAliasing,    m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) );
     aCfg->Write( keyRenderRAY_ProceduralT,  m_settings.GetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES ) );
+    aCfg->Write( keyRenderRAY_Progressive,  m_settings.GetFlag( FL_RENDER_RAYTRACING_PROGRESSIVE_RENDER ) );
 
     aCfg->Write( keyShowAxis,               m_settings.GetFlag( FL_AXIS ) );
     aCfg->Write( keyShowGrid,               (int)m_settings.GridGet() );
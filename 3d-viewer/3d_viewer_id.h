@@ -77,6 +77,7 @@ enum id_3dview_frm
     ID_MENU3D_FL_RAYTRACING_POST_PROCESSING,
     ID_MENU3D_FL_RAYTRACING_ANTI_ALIASING,
     ID_MENU3D_FL_RAYTRACING_PROCEDURAL_TEXTURES,
+    ID_MENU3D_FL_RAYTRACING_PROGRESSIVE_RENDER,
 
     ID_MENU_SCREENCOPY_PNG,
     ID_MENU_SCREENCOPY_JPEG,
@@ -88,6 +88,11 @@ static const wxChar AllowLegacyCanvasInGtk3[] = wxT( "AllowLegacyCanvasInGtk3" )
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Report the time taken by each step of the electrical rules check in the ERC dialog
+ */
+static const wxChar ShowErcTimings[] = wxT( "ShowErcTimings" );
+
 } // namespace KEYS
 
 
@@ -169,6 +174,7 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_allowLegacyCanvasInGtk3 = false;
     m_realTimeConnectivity = true;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_showErcTimings = false;
 
     loadFromConfigFile();
 }
@@ -215,6 +221,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
             new PARAM_CFG_INT( true, AC_KEYS::CoroutineStackSize, &m_coroutineStackSize,
                     AC_STACK::default_stack, AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back(
+            new PARAM_CFG_BOOL( true, AC_KEYS::ShowErcTimings, &m_showErcTimings, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define SEG_BATCH_SSE2
+#endif
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_line_chain.h>
+
+
+int SEG_BATCH::Load( const SHAPE_LINE_CHAIN& aChain, int aFirst )
+{
+    m_chain = &aChain;
+    m_first = aFirst;
+    m_count = std::max( 0, std::min( SIZE, aChain.SegmentCount() - aFirst ) );
+
+    m_min = VECTOR2I( INT_MAX, INT_MAX );
+    m_max = VECTOR2I( INT_MIN, INT_MIN );
+
+    for( int i = 0; i < m_count; i++ )
+    {
+        const SEG s = aChain.CSegment( aFirst + i );
+
+        m_minX[i] = std::min( s.A.x, s.B.x );
+        m_minY[i] = std::min( s.A.y, s.B.y );
+        m_maxX[i] = std::max( s.A.x, s.B.x );
+        m_maxY[i] = std::max( s.A.y, s.B.y );
+
+        m_min.x = std::min( m_min.x, m_minX[i] );
+        m_min.y = std::min( m_min.y, m_minY[i] );
+        m_max.x = std::max( m_max.x, m_maxX[i] );
+        m_max.y = std::max( m_max.y, m_maxY[i] );
+    }
+
+    return m_count;
+}
+
+
+/* The bounding box filter of SHAPE_LINE_CHAIN::Collide() passes the segments whose box is
+ * closer than the clearance c to the box of the query segment. That can only happen if the
+ * boxes are closer than c on both axes, that is if on each axis
+ *      segment max >= query min - c + 1  and  segment min <= query max + c - 1
+ * The bounds are clamped to the int range, which does not change the result of the tests.
+ */
+static void axisBounds( int aA, int aB, int aClearance, int32_t& aLow, int32_t& aHigh )
+{
+    int64_t low = (int64_t) std::min( aA, aB ) - aClearance + 1;
+    int64_t high = (int64_t) std::max( aA, aB ) + aClearance - 1;
+
+    aLow = (int32_t) std::max<int64_t>( low, INT_MIN );
+    aHigh = (int32_t) std::min<int64_t>( high, INT_MAX );
+}
+
+
+uint64_t SEG_BATCH::candidates( const SEG& aSeg, int aClearance ) const
+{
+    int32_t lowX, highX, lowY, highY;
+
+    axisBounds( aSeg.A.x, aSeg.B.x, aClearance, lowX, highX );
+    axisBounds( aSeg.A.y, aSeg.B.y, aClearance, lowY, highY );
+
+    // No segment can pass if the whole batch is too far
+    if( m_max.x < lowX || m_min.x > highX || m_max.y < lowY || m_min.y > highY )
+        return 0;
+
+    uint64_t mask = 0;
+    int      i = 0;
+
+#ifdef SEG_BATCH_SSE2
+    const __m128i lx = _mm_set1_epi32( lowX );
+    const __m128i hx = _mm_set1_epi32( highX );
+    const __m128i ly = _mm_set1_epi32( lowY );
+    const __m128i hy = _mm_set1_epi32( highY );
+
+    for( ; i + 4 <= m_count; i += 4 )
+    {
+        __m128i minX = _mm_load_si128( reinterpret_cast<const __m128i*>( m_minX + i ) );
+        __m128i minY = _mm_load_si128( reinterpret_cast<const __m128i*>( m_minY + i ) );
+        __m128i maxX = _mm_load_si128( reinterpret_cast<const __m128i*>( m_maxX + i ) );
+        __m128i maxY = _mm_load_si128( reinterpret_cast<const __m128i*>( m_maxY + i ) );
+
+        __m128i fails = _mm_or_si128( _mm_or_si128( _mm_cmpgt_epi32( lx, maxX ),
+                                                    _mm_cmpgt_epi32( minX, hx ) ),
+                                      _mm_or_si128( _mm_cmpgt_epi32( ly, maxY ),
+                                                    _mm_cmpgt_epi32( minY, hy ) ) );
+
+        uint64_t passed = ~_mm_movemask_ps( _mm_castsi128_ps( fails ) ) & 0xF;
+
+        mask |= passed << i;
+    }
+#endif
+
+    // Scalar fallback, and the last segments
+    for( ; i < m_count; i++ )
+    {
+        if( m_maxX[i] >= lowX && m_minX[i] <= highX && m_maxY[i] >= lowY && m_minY[i] <= highY )
+            mask |= uint64_t( 1 ) << i;
+    }
+
+    return mask;
+}
+
+
+bool SEG_BATCH::Collide( const SEG& aSeg, int aClearance ) const
+{
+    uint64_t mask = candidates( aSeg, aClearance );
+
+    if( !mask )
+        return false;
+
+    // The exact tests of SHAPE_LINE_CHAIN::Collide() for the remaining segments
+    BOX2I              box_a( aSeg.A, aSeg.B - aSeg.A );
+    BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
+
+    for( int i = 0; mask; i++, mask >>= 1 )
+    {
+        if( !( mask & 1 ) )
+            continue;
+
+        const SEG s = m_chain->CSegment( m_first + i );
+        BOX2I     box_b( s.A, s.B - s.A );
+
+        if( box_a.SquaredDistance( box_b ) < dist_sq && s.Collide( aSeg, aClearance ) )
+            return true;
+    }
+
+    return false;
+}
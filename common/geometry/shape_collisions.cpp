@@ -221,11 +221,7 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_SEGMENT& aSeg, i
 static inline bool Collide( const SHAPE_LINE_CHAIN& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    for( int i = 0; i < aB.SegmentCount(); i++ )
-        if( aA.Collide( aB.CSegment( i ), aClearance ) )
-            return true;
-
-    return false;
+    return aA.Collide( aB, aClearance );
 }
 
 
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 
+#include <geometry/seg_batch.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_circle.h>
 #include <trigo.h>
@@ -68,6 +69,23 @@ void SHAPE_LINE_CHAIN::Rotate( double aAngle, const VECTOR2I& aCenter )
 
 bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
 {
+    // Nothing is closer than a zero clearance
+    if( aClearance == 0 )
+        return false;
+
+    if( aClearance > 0 )
+    {
+        SEG_BATCH batch;
+
+        for( int i = 0; batch.Load( *this, i ) > 0; i += SEG_BATCH::SIZE )
+        {
+            if( batch.Collide( aSeg, aClearance ) )
+                return true;
+        }
+
+        return false;
+    }
+
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
 
@@ -89,6 +107,35 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
 }
 
 
+bool SHAPE_LINE_CHAIN::Collide( const SHAPE_LINE_CHAIN& aChain, int aClearance ) const
+{
+    if( aClearance <= 0 )
+    {
+        for( int i = 0; i < aChain.SegmentCount(); i++ )
+        {
+            if( Collide( aChain.CSegment( i ), aClearance ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    // Every batch of our segments is loaded once and tested against all the other segments
+    SEG_BATCH batch;
+
+    for( int i = 0; batch.Load( *this, i ) > 0; i += SEG_BATCH::SIZE )
+    {
+        for( int j = 0; j < aChain.SegmentCount(); j++ )
+        {
+            if( batch.Collide( aChain.CSegment( j ), aClearance ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
 const SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Reverse() const
 {
     SHAPE_LINE_CHAIN a( *this );
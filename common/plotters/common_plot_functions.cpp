@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <mutex>
+
 #include <fctsys.h>
 #include <base_struct.h>
 #include <plotter.h>
@@ -55,6 +57,12 @@ void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
                     const PAGE_INFO& aPageInfo, int aSheetNumber, int aNumberOfSheets,
                     const wxString &aSheetDesc, const wxString &aFilename, const COLOR4D aColor )
 {
+    // The draw items are built from the global page layout model, which keeps its own list of
+    // the items built.  The layers of a board can be plotted in parallel (FAB_OUTPUT_JOB), so
+    // only one frame is built and plotted at a time.
+    static std::mutex worksheetMutex;
+    std::lock_guard<std::mutex> lock( worksheetMutex );
+
     /* Note: Page sizes values are given in mils
      */
     double   iusPerMil = plotter->GetIUsPerDecimil() * 10.0;
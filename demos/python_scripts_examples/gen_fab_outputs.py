@@ -0,0 +1,52 @@
+'''
+    A python script example to create all the files to build a board at once:
+    Gerber files of the layers selected in the board plot settings
+    Gerber job file
+    Drill files
+    Placement files
+
+    The files are created in parallel, each one with its own plotter or writer.
+
+    usage: gen_fab_outputs.py <board file> [output directory]
+'''
+
+import sys
+
+from pcbnew import *
+
+filename = sys.argv[1]
+plotDir = sys.argv[2] if len(sys.argv) > 2 else "plot/"
+
+board = LoadBoard(filename)
+
+job = FAB_OUTPUT_JOB(board)
+
+popt = job.GetPlotOptions()
+popt.SetOutputDirectory(plotDir)
+popt.SetFormat(PLOT_FORMAT_GERBER)
+popt.SetPlotFrameRef(False)
+popt.SetUseGerberAttributes(True)
+popt.SetIncludeGerberNetlistInfo(True)
+popt.SetCreateGerberJobFile(True)
+popt.SetUseAuxOrigin(True)
+
+# The board plot settings select the layers; one can also choose them here:
+# job.SetLayers(LSET())
+# job.AddLayer(F_Cu)
+
+metricFmt = True
+mergeNPTH = False
+genMap = False
+job.SetDrillFormat(FAB_OUTPUT_JOB.EXCELLON_DRILL_FILES)
+job.SetDrillOptions(metricFmt, mergeNPTH, genMap)
+
+job.SetPlacementFormat(FAB_OUTPUT_JOB.CSV_PLACEMENT_FILES)
+
+# 0 uses all the cores
+job.SetThreadCount(0)
+
+if not job.Run():
+    print("some files could not be created")
+
+for name in job.GetOutputFiles():
+    print("created %s" % name)
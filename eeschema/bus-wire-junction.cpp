@@ -57,22 +57,11 @@ void SCH_EDIT_FRAME::GetSchematicConnections( std::vector< wxPoint >& aConnectio
 
 bool SCH_EDIT_FRAME::TestDanglingEnds()
 {
-    std::vector<DANGLING_END_ITEM> endPoints;
-    bool hasStateChanged = false;
-
-    for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
-        item->GetEndPoints( endPoints );
-
-    for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
-    {
-        if( item->UpdateDanglingState( endPoints ) )
-        {
-            GetCanvas()->GetView()->Update( item, KIGFX::REPAINT );
-            hasStateChanged = true;
-        }
-    }
-
-    return hasStateChanged;
+    return GetScreen()->TestDanglingEnds( [&]( SCH_ITEM* aItem )
+                                          {
+                                              GetCanvas()->GetView()->Update( aItem,
+                                                                              KIGFX::REPAINT );
+                                          } );
 }
 
 
@@ -271,6 +260,7 @@ bool SCH_EDIT_FRAME::BreakSegment( SCH_LINE* aSegment, const wxPoint& aPoint,
 
     RefreshItem( aSegment );
     aSegment->SetEndPoint( aPoint );
+    aScreen->Update( aSegment );
 
     if( aNewSegment )
         *aNewSegment = newSegment;
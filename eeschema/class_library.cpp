@@ -58,7 +58,7 @@
 PART_LIB::PART_LIB( int aType, const wxString& aFileName, SCH_IO_MGR::SCH_FILE_T aPluginType ) :
     // start @ != 0 so each additional library added
     // is immediately detectable, zero would not be.
-    m_mod_hash( PART_LIBS::s_modify_generation ),
+    m_mod_hash( PART_LIBS::s_modify_generation.load() ),
     m_pluginType( aPluginType )
 {
     type = aType;
@@ -402,7 +402,7 @@ void PART_LIBS::FindLibraryNearEntries( std::vector<LIB_PART*>& aCandidates,
 }
 
 
-int PART_LIBS::s_modify_generation = 1;     // starts at 1 and goes up
+std::atomic<int> PART_LIBS::s_modify_generation( 1 );     // starts at 1 and goes up
 
 
 int PART_LIBS::GetModifyHash()
@@ -417,7 +417,7 @@ int PART_LIBS::GetModifyHash()
     // Rebuilding the cache (m_cache) does not change the GetModHash() value,
     // but changes PART_LIBS::s_modify_generation.
     // Take this change in account:
-    hash += PART_LIBS::s_modify_generation;
+    hash += PART_LIBS::s_modify_generation.load();
 
     return hash;
 }
@@ -32,6 +32,8 @@
 
 #include <wx/regex.h>
 #include <algorithm>
+#include <map>
+#include <tuple>
 #include <vector>
 #include <unordered_set>
 
@@ -238,41 +240,6 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
-{
-    int expectedId = aFirstValue;
-
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
-
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId <= aIdList[ii] )
-            break;
-    }
-
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
-
-        expectedId++;
-    }
-
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
-    return expectedId;
-}
-
-
 // A helper function to build a full reference string of a SCH_REFERENCE item
 wxString buildFullReference( const SCH_REFERENCE& aItem, int aUnitNumber = -1 )
 {
@@ -334,10 +301,116 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     // inUseRefs keep trace of previously allocated references
     std::unordered_set<wxString> inUseRefs;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // The reference numbers in use for each reference prefix, with the count of references
+    // using each of them.  Kept up to date as references are renumbered.
+    std::map<std::string, std::map<int, int>> refIdsInUse;
+
+    // The annotated references using each prefix and number, i.e. the units in use of each
+    // package.  Entries are not removed when a reference is renumbered, so they are checked
+    // again when looked up.
+    std::map<std::pair<std::string, int>, std::vector<unsigned>> packageUnits;
+
+    // The references not yet annotated for each prefix, value and symbol name, which are the
+    // candidates for the other units of a new multi-unit package.
+    std::map<std::tuple<std::string, wxString, std::string>, std::vector<unsigned>> newUnits;
+
+    // The indexes of each component instance (component and sheet path), and the locked
+    // units list it belongs to, if any.
+    typedef std::pair<SCH_COMPONENT*, wxString> INSTANCE_KEY;
+    std::map<INSTANCE_KEY, std::vector<unsigned>> instances;
+    std::map<INSTANCE_KEY, SCH_REFERENCE_LIST*>   lockedLists;
+
+    auto unitsKey = []( const SCH_REFERENCE& aRef )
+    {
+        return std::make_tuple( std::string( aRef.m_Ref ), aRef.m_Value->GetText(),
+                                std::string( aRef.m_RootCmp->GetLibId().GetLibItemName() ) );
+    };
+
+    auto instanceKey = []( const SCH_REFERENCE& aRef )
+    {
+        return INSTANCE_KEY( aRef.GetComp(), aRef.GetSheetPath().Path() );
+    };
+
+    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
+    {
+        SCH_REFERENCE& ref = componentFlatList[ii];
+
+        refIdsInUse[ ref.m_Ref ][ ref.m_NumRef ]++;
+
+        if( ref.m_IsNew )
+            newUnits[ unitsKey( ref ) ].push_back( ii );
+        else
+            packageUnits[ std::make_pair( std::string( ref.m_Ref ), ref.m_NumRef ) ].push_back( ii );
+
+        if( !aLockedUnitMap.empty() )
+            instances[ instanceKey( ref ) ].push_back( ii );
+    }
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+        {
+            // The first list holding an instance wins.
+            lockedLists.emplace( instanceKey( pair.second[thisRefI] ), &pair.second );
+        }
+    }
+
+    // Renumber a reference, keeping refIdsInUse and packageUnits up to date.
+    auto setRefId = [&]( unsigned aIndex, int aNumRef, bool aIsNew )
+    {
+        SCH_REFERENCE&      ref = componentFlatList[aIndex];
+        std::map<int, int>& ids = refIdsInUse[ ref.m_Ref ];
+        auto                it = ids.find( ref.m_NumRef );
+
+        if( it != ids.end() && --it->second == 0 )
+            ids.erase( it );
+
+        ref.m_NumRef = aNumRef;
+        ref.m_IsNew = aIsNew;
+        ids[ aNumRef ]++;
+
+        if( !aIsNew )
+            packageUnits[ std::make_pair( std::string( ref.m_Ref ), aNumRef ) ].push_back( aIndex );
+    };
+
+    // Return the index of another annotated unit aUnit of the package of the reference at
+    // aIndex, or -1.
+    auto findUnit = [&]( unsigned aIndex, int aUnit ) -> int
+    {
+        const SCH_REFERENCE& ref = componentFlatList[aIndex];
+        auto it = packageUnits.find( std::make_pair( std::string( ref.m_Ref ), ref.m_NumRef ) );
+
+        if( it == packageUnits.end() )
+            return -1;
+
+        for( unsigned jj : it->second )
+        {
+            const SCH_REFERENCE& other = componentFlatList[jj];
+
+            if( jj == aIndex || other.m_IsNew || other.m_NumRef != ref.m_NumRef
+                    || other.CompareRef( ref ) != 0 )
+                continue;
+
+            if( other.m_Unit == aUnit )
+                return (int) jj;
+        }
+
+        return -1;
+    };
+
+    // The reference numbers are allocated in increasing order within a group of references,
+    // so the search for a free one restarts where the previous one ended.
+    int nextRefId = minRefId;
+
+    auto createFirstFreeRefId = [&]( unsigned aIndex ) -> int
+    {
+        const std::map<int, int>& ids = refIdsInUse[ componentFlatList[aIndex].m_Ref ];
+
+        while( ids.count( nextRefId ) )
+            nextRefId++;
+
+        return nextRefId++;
+    };
 #endif
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
@@ -348,21 +421,13 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
 
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+        if( !lockedLists.empty() )
+        {
+            auto it = lockedLists.find( instanceKey( ref_unit ) );
 
-                if( thisRef.IsSameInstance( ref_unit ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
+            if( it != lockedLists.end() )
+                lockedList = it->second;
         }
 
         if(  ( componentFlatList[first].CompareRef( ref_unit ) != 0 )
@@ -386,7 +451,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             else
                 minRefId = aStartNumber + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            nextRefId = minRefId;
 #endif
         }
 
@@ -397,10 +462,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             {
 #ifdef USE_OLD_ALGO
                 LastReferenceNumber++;
+                ref_unit.m_NumRef = LastReferenceNumber;
 #else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = createFirstFreeRefId( ii );
+                setRefId( ii, LastReferenceNumber, false );
 #endif
-                ref_unit.m_NumRef = LastReferenceNumber;
             }
 
             ref_unit.m_Unit  = 1;
@@ -416,10 +482,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         {
 #ifdef USE_OLD_ALGO
             LastReferenceNumber++;
+            ref_unit.m_NumRef = LastReferenceNumber;
 #else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = createFirstFreeRefId( ii );
+            setRefId( ii, LastReferenceNumber, true );
 #endif
-            ref_unit.m_NumRef = LastReferenceNumber;
 
             if( !ref_unit.IsUnitsLocked() )
                 ref_unit.m_Unit = 1;
@@ -452,9 +519,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                for( unsigned jj : instances[ instanceKey( thisRef ) ] )
                 {
-                    if( ! thisRef.IsSameInstance( componentFlatList[jj] ) )
+                    if( jj <= ii )
                         continue;
 
                     wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_Unit );
@@ -464,9 +531,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     // multiunits components have duplicate references)
                     if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
                     {
-                        componentFlatList[jj].m_NumRef = ref_unit.m_NumRef;
+                        setRefId( jj, ref_unit.m_NumRef, false );
                         componentFlatList[jj].m_Unit = thisRef.m_Unit;
-                        componentFlatList[jj].m_IsNew = false;
                         componentFlatList[jj].m_Flag = 1;
                         // lock this new full reference
                         inUseRefs.insert( ref_candidate );
@@ -486,28 +552,23 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( ref_unit.m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
+                int found = findUnit( ii, Unit );
 
                 if( found >= 0 )
                     continue; // this unit exists for this reference (unit already annotated)
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                const std::vector<unsigned>& candidates = newUnits[ unitsKey( ref_unit ) ];
+
+                for( auto it = std::upper_bound( candidates.begin(), candidates.end(), ii );
+                     it != candidates.end(); ++it )
                 {
+                    unsigned jj = *it;
                     auto& cmp_unit = componentFlatList[jj];
 
                     if( cmp_unit.m_Flag )    // already tested
                         continue;
 
-                    if( cmp_unit.CompareRef( ref_unit ) != 0 )
-                        continue;
-
-                    if( cmp_unit.CompareValue( ref_unit ) != 0 )
-                        continue;
-
-                    if( cmp_unit.CompareLibName( ref_unit ) != 0 )
-                        continue;
-
                     if( aUseSheetNum &&
                             cmp_unit.GetSheetPath().Cmp( ref_unit.GetSheetPath() ) != 0 )
                         continue;
@@ -519,10 +580,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     if( !cmp_unit.IsUnitsLocked()
                         || ( cmp_unit.m_Unit == Unit ) )
                     {
-                        cmp_unit.m_NumRef = ref_unit.m_NumRef;
+                        setRefId( jj, ref_unit.m_NumRef, false );
                         cmp_unit.m_Unit   = Unit;
                         cmp_unit.m_Flag   = 1;
-                        cmp_unit.m_IsNew  = false;
                         break;
                     }
                 }
@@ -24,6 +24,7 @@
 #include <future>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <profile.h>
 
 #include <advanced_config.h>
@@ -352,15 +353,23 @@ bool CONNECTION_GRAPH::m_allowRealTime = true;
 
 
 void CONNECTION_GRAPH::Reset()
+{
+    resetSubgraphs();
+
+    m_items.clear();
+    m_sheet_items.clear();
+    m_invisible_power_pins.clear();
+}
+
+
+void CONNECTION_GRAPH::resetSubgraphs()
 {
     for( auto subgraph : m_subgraphs )
         delete subgraph;
 
-    m_items.clear();
     m_subgraphs.clear();
     m_driver_subgraphs.clear();
     m_sheet_to_subgraphs_map.clear();
-    m_invisible_power_pins.clear();
     m_bus_alias_cache.clear();
     m_net_name_to_code_map.clear();
     m_bus_name_to_code_map.clear();
@@ -381,35 +390,137 @@ void CONNECTION_GRAPH::Recalculate( SCH_SHEET_LIST aSheetList, bool aUncondition
 
     if( aUnconditional )
         Reset();
+    else
+        resetSubgraphs();
+
+    // Forget the sheets that left the hierarchy: their items may have been deleted
+    std::unordered_set<SCH_SHEET_PATH> current_sheets( aSheetList.begin(), aSheetList.end() );
+
+    for( auto it = m_sheet_items.begin(); it != m_sheet_items.end(); )
+    {
+        if( current_sheets.count( it->first ) )
+            ++it;
+        else
+            it = m_sheet_items.erase( it );
+    }
+
+    m_invisible_power_pins.erase(
+            std::remove_if( m_invisible_power_pins.begin(), m_invisible_power_pins.end(),
+                            [&] ( const std::pair<SCH_SHEET_PATH, SCH_PIN*>& aPin ) {
+                                return !current_sheets.count( aPin.first );
+                            } ), m_invisible_power_pins.end() );
+
+    // A screen must be linked again when it or one of its items changed, and for all the
+    // sheets using it
+    std::unordered_set<SCH_SCREEN*> dirty_screens;
 
     for( const auto& sheet : aSheetList )
     {
-        std::vector<SCH_ITEM*> items;
+        SCH_SCREEN* screen = sheet.LastScreen();
+        auto        cached = m_sheet_items.find( sheet );
 
-        for( auto item = sheet.LastScreen()->GetDrawItems();
-             item; item = item->Next() )
+        // The sheet may have been given another screen, and its old one deleted
+        if( aUnconditional || cached == m_sheet_items.end() || cached->second.m_screen != screen
+                || screen->IsConnectivityDirty() )
         {
-            if( item->IsConnectable() &&
-                ( aUnconditional || item->IsConnectivityDirty() ) )
+            dirty_screens.insert( screen );
+            continue;
+        }
+
+        for( auto item = screen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->IsConnectable() && item->IsConnectivityDirty() )
             {
-                items.push_back( item );
+                dirty_screens.insert( screen );
+                break;
             }
         }
+    }
+
+    // Items only link to items of their own screen, so screens can be processed in parallel.
+    // The sheet paths sharing a screen touch the same items and are processed in sequence.
+    std::vector<std::vector<SCH_SHEET_PATH>> screen_sheets;
+    std::unordered_map<SCH_SCREEN*, size_t>  screen_index;
+
+    for( const auto& sheet : aSheetList )
+    {
+        auto it = screen_index.emplace( sheet.LastScreen(), screen_sheets.size() ).first;
+
+        if( it->second == screen_sheets.size() )
+            screen_sheets.emplace_back();
 
-        updateItemConnectivity( sheet, items );
+        screen_sheets[ it->second ].push_back( sheet );
+
+        // Create the entries now: the threads below only look them up with at(), as
+        // inserting into the map from several threads is not safe
+        m_sheet_items[ sheet ];
     }
 
-    update_items.Stop();
-    wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
+    // The dangling end test queries the screen index.  Building it computes text bounding
+    // boxes, which are not thread safe, so build the indexes before the threads start.
+    for( SCH_SCREEN* screen : dirty_screens )
+        screen->BuildIndex();
+
+    std::atomic<size_t> nextScreen( 0 );
+
+    auto update_lambda = [&]() -> size_t
+    {
+        for( size_t ii = nextScreen++; ii < screen_sheets.size(); ii = nextScreen++ )
+        {
+            SCH_SCREEN* screen = screen_sheets[ii].front().LastScreen();
+
+            if( !dirty_screens.count( screen ) )
+            {
+                for( const auto& sheet : screen_sheets[ii] )
+                    resetItemConnections( sheet );
+
+                continue;
+            }
 
-    PROF_COUNTER tde;
+            std::vector<SCH_ITEM*> items;
 
-    // IsDanglingStateChanged() also adds connected items for things like SCH_TEXT
-    SCH_SCREENS schematic;
-    schematic.TestDanglingEnds();
+            for( auto item = screen->GetDrawItems(); item; item = item->Next() )
+            {
+                if( item->IsConnectable() )
+                    items.push_back( item );
+            }
 
-    tde.Stop();
-    wxLogTrace( "CONN_PROFILE", "TestDanglingEnds() %0.4f ms", tde.msecs() );
+            for( const auto& sheet : screen_sheets[ii] )
+                updateItemConnectivity( sheet, items );
+
+            // IsDanglingStateChanged() also adds connected items for things like SCH_TEXT
+            screen->TestDanglingEnds();
+            screen->SetConnectivityDirty( false );
+        }
+
+        return 1;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   dirty_screens.size() );
+
+    if( parallelThreadCount <= 1 )
+        update_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, update_lambda );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    m_items.clear();
+
+    for( const auto& it : m_sheet_items )
+        m_items.insert( it.second.m_items.begin(), it.second.m_items.end() );
+
+    update_items.Stop();
+    wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms, %zu of %zu screens",
+                update_items.msecs(), dirty_screens.size(), screen_sheets.size() );
 
     PROF_COUNTER build_graph;
 
@@ -434,10 +545,56 @@ void CONNECTION_GRAPH::Recalculate( SCH_SHEET_LIST aSheetList, bool aUncondition
 }
 
 
+/**
+ * Sets the bus/net type of the connection of \a aItem, as known before the graph is built.
+ */
+static void setConnectionType( SCH_ITEM* aItem, SCH_CONNECTION* aConnection )
+{
+    switch( aItem->Type() )
+    {
+    case SCH_LINE_T:
+        aConnection->SetType( aItem->GetLayer() == LAYER_BUS ? CONNECTION_BUS : CONNECTION_NET );
+        break;
+
+    case SCH_BUS_BUS_ENTRY_T:
+        aConnection->SetType( CONNECTION_BUS );
+        break;
+
+    case SCH_PIN_T:
+    case SCH_BUS_WIRE_ENTRY_T:
+        aConnection->SetType( CONNECTION_NET );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void CONNECTION_GRAPH::resetItemConnections( const SCH_SHEET_PATH& aSheet )
+{
+    // Called from worker threads: the entry must exist already, see Recalculate()
+    for( SCH_ITEM* item : m_sheet_items.at( aSheet ).m_items )
+    {
+        SCH_CONNECTION* conn = item->InitializeConnection( aSheet );
+
+        // Component and sheet pins get no type until the graph is built
+        if( item->Type() != SCH_PIN_T )
+            setConnectionType( item, conn );
+    }
+}
+
+
 void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                                std::vector<SCH_ITEM*> aItemList )
 {
     std::unordered_map< wxPoint, std::vector<SCH_ITEM*> > connection_map;
+    SHEET_ITEMS& cached = m_sheet_items.at( aSheet );
+    std::vector<SCH_ITEM*>& sheet_items = cached.m_items;
+    std::vector<SCH_PIN*> invisible_power_pins;
+
+    cached.m_screen = aSheet.LastScreen();
+    sheet_items.clear();
 
     for( auto item : aItemList )
     {
@@ -458,7 +615,7 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
                 pin.Connection( aSheet )->Reset();
 
                 connection_map[ pin.GetTextPos() ].push_back( &pin );
-                m_items.insert( &pin );
+                sheet_items.push_back( &pin );
             }
         }
         else if( item->Type() == SCH_COMPONENT_T )
@@ -475,44 +632,36 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 
                 wxPoint pos = t.TransformCoordinate( pin.GetPosition() ) + component->GetPosition();
 
-                // because calling the first time is not thread-safe
+                // Cache the default net name now, while no other thread uses this pin
                 pin.GetDefaultNetName( aSheet );
                 pin.ConnectedItems().clear();
 
                 // Invisible power pins need to be post-processed later
 
                 if( pin.IsPowerConnection() && !pin.IsVisible() )
-                    m_invisible_power_pins.emplace_back( std::make_pair( aSheet, &pin ) );
+                    invisible_power_pins.push_back( &pin );
 
                 connection_map[ pos ].push_back( &pin );
-                m_items.insert( &pin );
+                sheet_items.push_back( &pin );
             }
         }
         else
         {
-            m_items.insert( item );
+            sheet_items.push_back( item );
             auto conn = item->InitializeConnection( aSheet );
 
             // Set bus/net property here so that the propagation code uses it
+            setConnectionType( item, conn );
+
             switch( item->Type() )
             {
-            case SCH_LINE_T:
-                conn->SetType( item->GetLayer() == LAYER_BUS ? CONNECTION_BUS : CONNECTION_NET );
-                break;
-
             case SCH_BUS_BUS_ENTRY_T:
-                conn->SetType( CONNECTION_BUS );
                 // clean previous (old) links:
                 static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[0] = nullptr;
                 static_cast<SCH_BUS_BUS_ENTRY*>( item )->m_connected_bus_items[1] = nullptr;
                 break;
 
-            case SCH_PIN_T:
-                conn->SetType( CONNECTION_NET );
-                break;
-
             case SCH_BUS_WIRE_ENTRY_T:
-                conn->SetType( CONNECTION_NET );
                 // clean previous (old) link:
                 static_cast<SCH_BUS_WIRE_ENTRY*>( item )->m_connected_bus_item = nullptr;
                 break;
@@ -530,6 +679,20 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
         item->SetConnectivityDirty( false );
     }
 
+    {
+        // Other sheets may be updated at the same time
+        std::lock_guard<std::mutex> lock( m_item_mutex );
+
+        m_invisible_power_pins.erase(
+                std::remove_if( m_invisible_power_pins.begin(), m_invisible_power_pins.end(),
+                                [&] ( const std::pair<SCH_SHEET_PATH, SCH_PIN*>& aPin ) {
+                                    return aPin.first == aSheet;
+                                } ), m_invisible_power_pins.end() );
+
+        for( SCH_PIN* pin : invisible_power_pins )
+            m_invisible_power_pins.emplace_back( std::make_pair( aSheet, pin ) );
+    }
+
     for( const auto& it : connection_map )
     {
         auto connection_vec = it.second;
@@ -209,6 +209,11 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
+     * Unless \a aUnconditional is set, the graphical connectivity of the items is only
+     * recomputed for the sheets whose screen (or one of its items) has its connectivity dirty;
+     * the other sheets reuse the item links of the previous run.  Subgraphs, driver resolution
+     * and hierarchical propagation are then rebuilt from the items of all the sheets.
+     *
      * @param aSheetList is the list of possibly modified sheets
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
@@ -252,6 +257,19 @@ private:
 
     std::unordered_set<SCH_ITEM*> m_items;
 
+    // The items (including component pins and sheet pins) linked on a sheet, and the screen
+    // they belong to.  A sheet path keeps its key when the sheet gets another screen, so the
+    // screen tells whether the items are still the ones of the sheet.
+    struct SHEET_ITEMS
+    {
+        SCH_SCREEN*            m_screen = nullptr;
+        std::vector<SCH_ITEM*> m_items;
+    };
+
+    // The items linked on each sheet, kept between runs so that unmodified sheets do not
+    // need to be linked again
+    std::unordered_map<SCH_SHEET_PATH, SHEET_ITEMS> m_sheet_items;
+
     // The owner of all CONNECTION_SUBGRAPH objects
     std::vector<CONNECTION_SUBGRAPH*> m_subgraphs;
 
@@ -311,7 +329,11 @@ private:
      * checks to ensure that the items should actually connect, the items are
      * linked together using ConnectedItems().
      *
-     * As a side effect, items are loaded into m_items for BuildConnectionGraph()
+     * As a side effect, items are loaded into m_sheet_items for BuildConnectionGraph()
+     *
+     * Only touches the items of aItemList and their pins, so it can run for several
+     * sheets at once as long as they do not share a screen.  The m_sheet_items entry
+     * of aSheet must exist before the call.
      *
      * @param aSheet is the path to the sheet of all items in the list
      * @param aItemList is a list of items to consider
@@ -319,6 +341,20 @@ private:
     void updateItemConnectivity( SCH_SHEET_PATH aSheet,
                                  std::vector<SCH_ITEM*> aItemList );
 
+    /**
+     * Resets the connections of the items of \a aSheet for a new run of
+     * buildConnectionGraph(), keeping the graphical links made by the last
+     * updateItemConnectivity() on this sheet.
+     *
+     * @param aSheet is a sheet whose items did not change since they were last linked
+     */
+    void resetItemConnections( const SCH_SHEET_PATH& aSheet );
+
+    /**
+     * Deletes all subgraphs and clears the net, bus and label caches derived from them.
+     */
+    void resetSubgraphs();
+
     /**
      * Generates the connection graph (after all item connectivity has been updated)
      *
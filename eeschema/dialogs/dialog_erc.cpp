@@ -24,6 +24,8 @@
  */
 
 #include <fctsys.h>
+#include <advanced_config.h>
+#include <profile.h>
 #include <gestfich.h>
 #include <pgm_base.h>
 #include <sch_screen.h>
@@ -491,6 +493,21 @@ void DIALOG_ERC::TestErc( REPORTER& aReporter )
 
     transferControlsToSettings();
 
+    // In timing mode, the time taken by each step is added to the messages
+    bool         showTimings = ADVANCED_CFG::GetCfg().m_showErcTimings;
+    PROF_COUNTER stepTimer;
+
+    auto reportTiming =
+            [&]( const wxString& aStep )
+            {
+                if( showTimings )
+                {
+                    aReporter.ReportTail( wxString::Format( _( "%s: %.1f ms" ), aStep,
+                                                            stepTimer.msecs( true ) ),
+                                          REPORTER::RPT_INFO );
+                }
+            };
+
     // Build the whole sheet list in hierarchy (sheet, not screen)
     SCH_SHEET_LIST sheets( g_RootSheet );
     sheets.AnnotatePowerSymbols();
@@ -503,6 +520,8 @@ void DIALOG_ERC::TestErc( REPORTER& aReporter )
         return;
     }
 
+    reportTiming( _( "Annotation check" ) );
+
     SCH_SCREENS screens;
 
     // Erase all previous DRC markers.
@@ -514,105 +533,84 @@ void DIALOG_ERC::TestErc( REPORTER& aReporter )
 
     TestConflictingBusAliases();
 
+    reportTiming( _( "Sheet names and bus aliases" ) );
+
     // The connection graph has a whole set of ERC checks it can run
     m_parent->RecalculateConnections( NO_CLEANUP );
     g_ConnectionGraph->RunERC( m_settings );
 
+    reportTiming( _( "Connection graph" ) );
+
     // Test is all units of each multiunit component have the same footprint assigned.
     TestMultiunitFootprints( sheets );
 
+    reportTiming( _( "Multiunit footprints" ) );
+
     std::unique_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( m_parent->BuildNetListBase() );
 
+    reportTiming( _( "Netlist" ) );
+
     // Reset the connection type indicator
     objectsConnectedList->ResetConnectionsType();
 
     unsigned lastItemIdx = 0;
-    unsigned nextItemIdx = 0;
-    int MinConn    = NOC;
 
     // Check that a pin appears in only one net.  This check is necessary because multi-unit
     // components that have shared pins could be wired to different nets.
     std::unordered_map<wxString, wxString> pin_to_net_map;
 
-    // The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted by net number, which
-    // means we can group netlist items into ranges that live in the same net. The range from
-    // nextItem to the current item (exclusive) needs to be checked against the current item.
-    // The lastItem variable is used as a helper to pass the last item's number from one loop
-    // iteration to the next, which simplifies the initial pass.
+    // The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted by net number.
     for( unsigned itemIdx = 0; itemIdx < objectsConnectedList->size(); itemIdx++ )
     {
         auto item = objectsConnectedList->GetItem( itemIdx );
         auto lastItem = objectsConnectedList->GetItem( lastItemIdx );
 
-        auto lastNet = lastItem->GetNet();
-        auto net = item->GetNet();
-
-        wxASSERT_MSG( lastNet <= net, wxT( "Netlist not correctly ordered" ) );
-
-        if( lastNet != net )
-        {
-            // New net found:
-            MinConn      = NOC;
-            nextItemIdx = itemIdx;
-        }
+        wxASSERT_MSG( lastItem->GetNet() <= item->GetNet(), wxT( "Netlist not correctly ordered" ) );
 
-        switch( item->m_Type )
+        // Check if this pin has appeared before on a different net
+        if( item->m_Type == NET_PIN && item->m_Link )
         {
-        // These items do not create erc problems
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_PINLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-            break;
+            auto ref = item->GetComponentParent()->GetRef( &item->m_SheetPath );
+            wxString pin_name = ref + "_" + item->m_PinNum;
 
-        // TODO(JE) Port this to the new system
-        case NET_PIN:
-        {
-            // Check if this pin has appeared before on a different net
-            if( item->m_Link )
+            if( pin_to_net_map.count( pin_name ) == 0 )
             {
-                auto ref = item->GetComponentParent()->GetRef( &item->m_SheetPath );
-                wxString pin_name = ref + "_" + item->m_PinNum;
-
-                if( pin_to_net_map.count( pin_name ) == 0 )
-                {
-                    pin_to_net_map[pin_name] = item->GetNetName();
-                }
-                else if( pin_to_net_map[pin_name] != item->GetNetName() )
-                {
-                    SCH_MARKER* marker = new SCH_MARKER();
+                pin_to_net_map[pin_name] = item->GetNetName();
+            }
+            else if( pin_to_net_map[pin_name] != item->GetNetName() )
+            {
+                SCH_MARKER* marker = new SCH_MARKER();
 
-                    marker->SetTimeStamp( GetNewTimeStamp() );
-                    marker->SetData( ERCE_DIFFERENT_UNIT_NET, item->m_Start,
-                        wxString::Format( _( "Pin %s on %s is connected to both %s and %s" ),
-                        item->m_PinNum, ref, pin_to_net_map[pin_name], item->GetNetName() ),
-                        item->m_Start );
-                    marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
-                    marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
+                marker->SetTimeStamp( GetNewTimeStamp() );
+                marker->SetData( ERCE_DIFFERENT_UNIT_NET, item->m_Start,
+                    wxString::Format( _( "Pin %s on %s is connected to both %s and %s" ),
+                    item->m_PinNum, ref, pin_to_net_map[pin_name], item->GetNetName() ),
+                    item->m_Start );
+                marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
+                marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
 
-                    item->m_SheetPath.LastScreen()->Append( marker );
-                }
+                item->m_SheetPath.LastScreen()->Append( marker );
             }
-
-            // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList.get(), itemIdx, nextItemIdx, &MinConn );
-            break;
-        }
-        default:
-        break;
         }
 
         lastItemIdx = itemIdx;
     }
 
+    reportTiming( _( "Shared pins" ) );
+
+    // Look for ERC problems between pins:
+    // TODO(JE) Port this to the new system
+    TestNetsPins( objectsConnectedList.get() );
+
+    reportTiming( _( "Pin to pin conflicts" ) );
+
     // Test similar labels (i;e. labels which are identical when
     // using case insensitive comparisons)
     if( m_settings.check_similar_labels )
+    {
         objectsConnectedList->TestforSimilarLabels();
+        reportTiming( _( "Similar labels" ) );
+    }
 
     // Displays global results:
     updateMarkerCounts( &screens );
@@ -40,6 +40,8 @@
 #include <sch_reference_list.h>
 #include <wx/ffile.h>
 
+#include <vector>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -414,139 +416,112 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst, int aMi
 }
 
 
-void TestOthersItems( NETLIST_OBJECT_LIST* aList, unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion )
+/**
+ * Perform ERC testing between the pins of the net found in \a aList from \a aNetStart to
+ * \a aNetEnd (exclusive).
+ *
+ * The pins are reduced to the histogram of their electrical types and, for each type, to
+ * the list of their positions in the net, so the conflict matrix is only evaluated once per
+ * pin and pin type, and not once per pair of pins.
+ */
+static void testNetPins( NETLIST_OBJECT_LIST* aList, unsigned aNetStart, unsigned aNetEnd )
 {
-    unsigned netItemTst = aNetStart;
-    ELECTRICAL_PINTYPE jj;
-    int erc = OK;
+    std::vector<unsigned> pins;
+    std::vector<unsigned> pinsByType[PINTYPE_COUNT];
+    size_t                nextOfType[PINTYPE_COUNT] = { 0 };
+    bool                  hasNoConnect = false;
 
-    /* Analysis of the table of connections. */
-    ELECTRICAL_PINTYPE ref_elect_type = aList->GetItem( aNetItemRef )->m_ElectricalPinType;
-    int local_minconn = NOC;
+    for( unsigned ii = aNetStart; ii < aNetEnd; ii++ )
+    {
+        switch( aList->GetItemType( ii ) )
+        {
+        case NET_NOCONNECT:
+            hasNoConnect = true;
+            break;
 
-    if( ref_elect_type == PIN_NC )
-        local_minconn = NPI;
+        case NET_PIN:
+            pinsByType[ aList->GetItem( ii )->m_ElectricalPinType ].push_back( pins.size() );
+            pins.push_back( ii );
+            break;
 
-    /* Test pins connected to NetItemRef */
-    for( ; ; netItemTst++ )
-    {
-        if( aNetItemRef == netItemTst )
-            continue;
+        default:
+            break;
+        }
+    }
 
-        // We examine only a given net. We stop the search if the net changes
-        if( ( netItemTst >= aList->size() ) // End of list
-            || ( aList->GetItemNet( aNetItemRef ) !=
-                 aList->GetItemNet( netItemTst ) ) ) // End of net
-        {
-            /* End net code found: minimum connection test. */
-            if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
-            {
-                /* Not connected or not driven pin. */
-                bool seterr = true;
+    int minConn = NOC;
 
-                if( local_minconn == NOC &&
-                    aList->GetItemType( aNetItemRef ) == NET_PIN )
-                {
-                    /* This pin is not connected: for multiple part per
-                     * package, and duplicated pin,
-                     * search for another instance of this pin
-                     * this will be flagged only if all instances of this pin
-                     * are not connected
-                     * TODO test also if instances connected are connected to
-                     * the same net
-                     */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
-
-                        if( duplicate == aNetItemRef )
-                            continue;
-
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
-                        // Same component and same pin. Do dot create error for this pin
-                        // if the other pin is connected (i.e. if duplicate net has another
-                        // item)
-                        if( (duplicate > 0)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate - 1 ) ) )
-                            seterr = false;
-
-                        if( (duplicate < aList->size() - 1)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate + 1 ) ) )
-                            seterr = false;
-                    }
-                }
+    for( unsigned ref = 0; ref < pins.size(); ref++ )
+    {
+        NETLIST_OBJECT*    refItem = aList->GetItem( pins[ref] );
+        ELECTRICAL_PINTYPE refType = refItem->m_ElectricalPinType;
 
-                if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+        // Skip the reference pin in the list of the pins of its type
+        nextOfType[refType]++;
 
-                *aMinConnexion = DRV;   // inhibiting other messages of this
-                                       // type for the net.
-            }
-            return;
+        // Conflict with the first following pin whose type is not OK with the reference pin
+        size_t conflict = pins.size();
+
+        for( int type = 0; type < PINTYPE_COUNT; type++ )
+        {
+            if( DiagErc[refType][type] != OK && nextOfType[type] < pinsByType[type].size() )
+                conflict = std::min( conflict, (size_t) pinsByType[type][ nextOfType[type] ] );
         }
 
-        switch( aList->GetItemType( netItemTst ) )
+        if( conflict < pins.size()
+          && aList->GetConnectionType( pins[conflict] ) == UNCONNECTED )
         {
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_HIERLABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETBUSLABELMEMBER:
-        case NET_SHEETLABEL:
-        case NET_GLOBLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-        case NET_PINLABEL:
-            break;
+            NETLIST_OBJECT* tstItem = aList->GetItem( pins[conflict] );
 
-        case NET_NOCONNECT:
-            local_minconn = std::max( NET_NC, local_minconn );
-            break;
+            Diagnose( refItem, tstItem, 0, DiagErc[refType][tstItem->m_ElectricalPinType] );
+            aList->SetConnectionType( pins[conflict], NOCONNECT_SYMBOL_PRESENT );
+        }
 
-        case NET_PIN:
-            jj = aList->GetItem( netItemTst )->m_ElectricalPinType;
-            local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+        // Minimal connection requirements of the reference pin
+        if( minConn >= NET_NC )
+            continue;
 
-            if( netItemTst <= aNetItemRef )
-                break;
+        int localMinConn = ( refType == PIN_NC ) ? NPI : NOC;
 
-            if( erc == OK )
-            {
-                erc = DiagErc[ref_elect_type][jj];
+        if( hasNoConnect )
+            localMinConn = std::max( NET_NC, localMinConn );
 
-                if( erc != OK )
-                {
-                    if( aList->GetConnectionType( netItemTst ) == UNCONNECTED )
-                    {
-                        Diagnose( aList->GetItem( aNetItemRef ),
-                                  aList->GetItem( netItemTst ),
-                                  0, erc );
-                        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
-                    }
-                }
-            }
+        for( int type = 0; type < PINTYPE_COUNT; type++ )
+        {
+            size_t others = pinsByType[type].size() - ( type == refType ? 1 : 0 );
 
-            break;
+            if( others )
+                localMinConn = std::max( MinimalReq[refType][type], localMinConn );
         }
+
+        if( localMinConn >= NET_NC )
+            continue;
+
+        // Diagnose() ignores pins which are not connected at all (NOC), so there is no need
+        // to look for the other instances of a pin shared by several units here.
+        Diagnose( refItem, NULL, localMinConn, WAR );
+
+        minConn = DRV;     // inhibiting other messages of this type for the net.
+    }
+}
+
+
+void TestNetsPins( NETLIST_OBJECT_LIST* aList )
+{
+    for( unsigned netStart = 0; netStart < aList->size(); )
+    {
+        unsigned netEnd = netStart + 1;
+
+        while( netEnd < aList->size()
+             && aList->GetItemNet( netEnd ) == aList->GetItemNet( netStart ) )
+            netEnd++;
+
+        testNetPins( aList, netStart, netEnd );
+        netStart = netEnd;
     }
 }
 
+
 int NETLIST_OBJECT_LIST::CountPinsInNet( unsigned aNetStart )
 {
     int count = 0;
@@ -99,17 +99,11 @@ void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst,
                       int MinConnexion, int Diag );
 
 /**
- * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
- * (mainly pin) on the same net.
- * @param aList = a reference to the list of connected objects
- * @param aNetItemRef = index in list of the current object
- * @param aNetStart = index in list of net objects of the first item
- * @param aMinConnexion = a pointer to a variable to store the minimal connection
- * found( NOD, DRV, NPI, NET_NC)
+ * Perform ERC testing for electrical conflicts between the pins of each net of \a aList,
+ * and for pins which are not connected or not driven.
+ * @param aList = the list of connected objects, sorted by net code
  */
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                             unsigned aNetItemRef, unsigned aNetStart,
-                             int* aMinConnexion );
+void TestNetsPins( NETLIST_OBJECT_LIST* aList );
 
 /**
  * Function TestDuplicateSheetNames( )
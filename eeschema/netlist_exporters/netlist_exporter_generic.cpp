@@ -38,6 +38,79 @@
 
 static bool sortPinsByNumber( LIB_PIN* aPin1, LIB_PIN* aPin2 );
 
+
+/**
+ * A #NETLIST_WRITER which builds an #XNODE tree, for the XML output.
+ */
+class XNODE_NETLIST_WRITER : public NETLIST_WRITER
+{
+public:
+    XNODE_NETLIST_WRITER() :
+        m_root( nullptr )
+    {}
+
+    ~XNODE_NETLIST_WRITER()
+    {
+        delete m_root;
+    }
+
+    void BeginNode( const char* aName ) override
+    {
+        XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+
+        addChild( n );
+        m_stack.emplace_back( n, nullptr );
+    }
+
+    void Attribute( const char* aName, const wxString& aValue ) override
+    {
+        m_stack.back().first->AddAttribute( aName, aValue );
+    }
+
+    void Content( const wxString& aText ) override
+    {
+        addChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aText ) );
+    }
+
+    void EndNode() override
+    {
+        m_stack.pop_back();
+    }
+
+    /// @return the root node, which is then owned by the caller.
+    XNODE* ReleaseRoot()
+    {
+        XNODE* root = m_root;
+        m_root = nullptr;
+        return root;
+    }
+
+private:
+    void addChild( XNODE* aNode )
+    {
+        if( m_stack.empty() )
+        {
+            wxASSERT( !m_root );
+            m_root = aNode;
+            return;
+        }
+
+        // wxXmlNode::AddChild() walks all of the existing children to find the last one.
+        XNODE*& last = m_stack.back().second;
+
+        if( last )
+            m_stack.back().first->InsertChildAfter( aNode, last );
+        else
+            m_stack.back().first->AddChild( aNode );
+
+        last = aNode;
+    }
+
+    XNODE*                               m_root;
+    std::vector<std::pair<XNODE*, XNODE*>> m_stack;   ///< Open nodes and their last child.
+};
+
+
 bool NETLIST_EXPORTER_GENERIC::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
     // Prepare list of nets generation
@@ -45,38 +118,40 @@ bool NETLIST_EXPORTER_GENERIC::WriteNetlist( const wxString& aOutFileName, unsig
         m_masterList->GetItem( ii )->m_Flag = 0;
 
     // output the XML format netlist.
-    wxXmlDocument   xdoc;
+    wxXmlDocument        xdoc;
+    XNODE_NETLIST_WRITER writer;
+
+    makeRoot( writer, GNL_ALL );
 
-    xdoc.SetRoot( makeRoot( GNL_ALL ) );
+    xdoc.SetRoot( writer.ReleaseRoot() );
 
     return xdoc.Save( aOutFileName, 2 /* indent bug, today was ignored by wxXml lib */ );
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeRoot( int aCtl )
+void NETLIST_EXPORTER_GENERIC::makeRoot( NETLIST_WRITER& aWriter, int aCtl )
 {
-    XNODE*      xroot = node( "export" );
-
-    xroot->AddAttribute( "version", "D" );
+    aWriter.BeginNode( "export" );
+    aWriter.Attribute( "version", "D" );
 
     if( aCtl & GNL_HEADER )
         // add the "design" header
-        xroot->AddChild( makeDesignHeader() );
+        makeDesignHeader( aWriter );
 
     if( aCtl & GNL_COMPONENTS )
-        xroot->AddChild( makeComponents() );
+        makeComponents( aWriter );
 
     if( aCtl & GNL_PARTS )
-        xroot->AddChild( makeLibParts() );
+        makeLibParts( aWriter );
 
     if( aCtl & GNL_LIBRARIES )
         // must follow makeGenericLibParts()
-        xroot->AddChild( makeLibraries() );
+        makeLibraries( aWriter );
 
     if( aCtl & GNL_NETS )
-        xroot->AddChild( makeListOfNets() );
+        makeListOfNets( aWriter );
 
-    return xroot;
+    aWriter.EndNode();
 }
 
 
@@ -91,7 +166,8 @@ struct COMP_FIELDS
 };
 
 
-void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet )
+void NETLIST_EXPORTER_GENERIC::addComponentFields( NETLIST_WRITER& aWriter, SCH_COMPONENT* comp,
+                                                   SCH_SHEET_PATH* aSheet )
 {
     COMP_FIELDS fields;
 
@@ -172,40 +248,42 @@ void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT*
 
     // Do not output field values blank in netlist:
     if( fields.value.size() )
-        xcomp->AddChild( node( "value", fields.value ) );
+        aWriter.Node( "value", fields.value );
     else    // value field always written in netlist
-        xcomp->AddChild( node( "value", "~" ) );
+        aWriter.Node( "value", "~" );
 
     if( fields.footprint.size() )
-        xcomp->AddChild( node( "footprint", fields.footprint ) );
+        aWriter.Node( "footprint", fields.footprint );
 
     if( fields.datasheet.size() )
-        xcomp->AddChild( node( "datasheet", fields.datasheet ) );
+        aWriter.Node( "datasheet", fields.datasheet );
 
     if( fields.f.size() )
     {
-        XNODE* xfields;
-        xcomp->AddChild( xfields = node( "fields" ) );
+        aWriter.BeginNode( "fields" );
 
         // non MANDATORY fields are output alphabetically
         for( std::map< wxString, wxString >::const_iterator it = fields.f.begin();
              it != fields.f.end();  ++it )
         {
-            XNODE*  xfield;
-            xfields->AddChild( xfield = node( "field", it->second ) );
-            xfield->AddAttribute( "name", it->first );
+            aWriter.BeginNode( "field" );
+            aWriter.Attribute( "name", it->first );
+            aWriter.Content( it->second );
+            aWriter.EndNode();
         }
+
+        aWriter.EndNode();
     }
 
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
+void NETLIST_EXPORTER_GENERIC::makeComponents( NETLIST_WRITER& aWriter )
 {
-    XNODE*      xcomps = node( "components" );
-
     wxString    timeStamp;
 
+    aWriter.BeginNode( "components" );
+
     m_ReferencesAlreadyFound.Clear();
 
     SCH_SHEET_LIST sheetList( g_RootSheet );
@@ -224,64 +302,61 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
 
             schItem = comp;
 
-            XNODE* xcomp;  // current component being constructed
-
             // Output the component's elements in order of expected access frequency.
             // This may not always look best, but it will allow faster execution
             // under XSL processing systems which do sequential searching within
             // an element.
 
-            xcomps->AddChild( xcomp = node( "comp" ) );
-            xcomp->AddAttribute( "ref", comp->GetRef( &sheetList[i] ) );
+            aWriter.BeginNode( "comp" );
+            aWriter.Attribute( "ref", comp->GetRef( &sheetList[i] ) );
 
-            addComponentFields( xcomp, comp, &sheetList[i] );
+            addComponentFields( aWriter, comp, &sheetList[i] );
 
-            XNODE*  xlibsource;
-            xcomp->AddChild( xlibsource = node( "libsource" ) );
+            aWriter.BeginNode( "libsource" );
 
             // "logical" library name, which is in anticipation of a better search
             // algorithm for parts based on "logical_lib.part" and where logical_lib
             // is merely the library name minus path and extension.
             if( comp->GetPartRef() )
-                xlibsource->AddAttribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
+                aWriter.Attribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
 
             // We only want the symbol name, not the full LIB_ID.
-            xlibsource->AddAttribute( "part", comp->GetLibId().GetLibItemName() );
+            aWriter.Attribute( "part", comp->GetLibId().GetLibItemName() );
 
-            xlibsource->AddAttribute( "description", comp->GetDescription() );
+            aWriter.Attribute( "description", comp->GetDescription() );
+            aWriter.EndNode();
 
-            XNODE* xsheetpath;
-
-            xcomp->AddChild( xsheetpath = node( "sheetpath" ) );
-            xsheetpath->AddAttribute( "names", sheetList[i].PathHumanReadable() );
-            xsheetpath->AddAttribute( "tstamps", sheetList[i].Path() );
+            aWriter.BeginNode( "sheetpath" );
+            aWriter.Attribute( "names", sheetList[i].PathHumanReadable() );
+            aWriter.Attribute( "tstamps", sheetList[i].Path() );
+            aWriter.EndNode();
 
             timeStamp.Printf( "%8.8lX", (unsigned long)comp->GetTimeStamp() );
-            xcomp->AddChild( node( "tstamp", timeStamp ) );
+            aWriter.Node( "tstamp", timeStamp );
+
+            aWriter.EndNode();
         }
     }
 
-    return xcomps;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
+void NETLIST_EXPORTER_GENERIC::makeDesignHeader( NETLIST_WRITER& aWriter )
 {
     SCH_SCREEN* screen;
-    XNODE*     xdesign = node( "design" );
-    XNODE*     xtitleBlock;
-    XNODE*     xsheet;
-    XNODE*     xcomment;
     wxString   sheetTxt;
     wxFileName sourceFileName;
 
+    aWriter.BeginNode( "design" );
+
     // the root sheet is a special sheet, call it source
-    xdesign->AddChild( node( "source", g_RootSheet->GetScreen()->GetFileName() ) );
+    aWriter.Node( "source", g_RootSheet->GetScreen()->GetFileName() );
 
-    xdesign->AddChild( node( "date", DateAndTime() ) );
+    aWriter.Node( "date", DateAndTime() );
 
     // which Eeschema tool
-    xdesign->AddChild( node( "tool", wxString( "Eeschema " ) + GetBuildVersion() ) );
+    aWriter.Node( "tool", wxString( "Eeschema " ) + GetBuildVersion() );
 
     /*
         Export the sheets information
@@ -292,101 +367,76 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
     {
         screen = sheetList[i].LastScreen();
 
-        xdesign->AddChild( xsheet = node( "sheet" ) );
+        aWriter.BeginNode( "sheet" );
 
         // get the string representation of the sheet index number.
         // Note that sheet->GetIndex() is zero index base and we need to increment the
         // number by one to make it human readable
         sheetTxt.Printf( "%u", i + 1 );
-        xsheet->AddAttribute( "number", sheetTxt );
-        xsheet->AddAttribute( "name", sheetList[i].PathHumanReadable() );
-        xsheet->AddAttribute( "tstamps", sheetList[i].Path() );
+        aWriter.Attribute( "number", sheetTxt );
+        aWriter.Attribute( "name", sheetList[i].PathHumanReadable() );
+        aWriter.Attribute( "tstamps", sheetList[i].Path() );
 
 
         TITLE_BLOCK tb = screen->GetTitleBlock();
 
-        xsheet->AddChild( xtitleBlock = node( "title_block" ) );
+        aWriter.BeginNode( "title_block" );
 
-        xtitleBlock->AddChild( node( "title", tb.GetTitle() ) );
-        xtitleBlock->AddChild( node( "company", tb.GetCompany() ) );
-        xtitleBlock->AddChild( node( "rev", tb.GetRevision() ) );
-        xtitleBlock->AddChild( node( "date", tb.GetDate() ) );
+        aWriter.Node( "title", tb.GetTitle() );
+        aWriter.Node( "company", tb.GetCompany() );
+        aWriter.Node( "rev", tb.GetRevision() );
+        aWriter.Node( "date", tb.GetDate() );
 
         // We are going to remove the fileName directories.
         sourceFileName = wxFileName( screen->GetFileName() );
-        xtitleBlock->AddChild( node( "source", sourceFileName.GetFullName() ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "1" );
-        xcomment->AddAttribute( "value", tb.GetComment( 0 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "2" );
-        xcomment->AddAttribute( "value", tb.GetComment( 1 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "3" );
-        xcomment->AddAttribute( "value", tb.GetComment( 2 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "4" );
-        xcomment->AddAttribute( "value", tb.GetComment( 3 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "5" );
-        xcomment->AddAttribute( "value", tb.GetComment( 4 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "6" );
-        xcomment->AddAttribute( "value", tb.GetComment( 5 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "7" );
-        xcomment->AddAttribute( "value", tb.GetComment( 6 ) );
+        aWriter.Node( "source", sourceFileName.GetFullName() );
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "8" );
-        xcomment->AddAttribute( "value", tb.GetComment( 7 ) );
+        for( int ii = 0; ii < 9; ++ii )
+        {
+            aWriter.BeginNode( "comment" );
+            aWriter.Attribute( "number", wxString::Format( "%d", ii + 1 ) );
+            aWriter.Attribute( "value", tb.GetComment( ii ) );
+            aWriter.EndNode();
+        }
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "9" );
-        xcomment->AddAttribute( "value", tb.GetComment( 8 ) );
+        aWriter.EndNode();      // title_block
+        aWriter.EndNode();      // sheet
     }
 
-    return xdesign;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibraries()
+void NETLIST_EXPORTER_GENERIC::makeLibraries( NETLIST_WRITER& aWriter )
 {
-    XNODE*  xlibs = node( "libraries" );     // auto_ptr
+    aWriter.BeginNode( "libraries" );
 
     for( std::set<wxString>::iterator it = m_libraries.begin(); it!=m_libraries.end();  ++it )
     {
         wxString    libNickname = *it;
-        XNODE*      xlibrary;
 
         if( m_libTable->HasLibrary( libNickname ) )
         {
-            xlibs->AddChild( xlibrary = node( "library" ) );
-            xlibrary->AddAttribute( "logical", libNickname );
-            xlibrary->AddChild( node( "uri",  m_libTable->GetFullURI( libNickname ) ) );
+            aWriter.BeginNode( "library" );
+            aWriter.Attribute( "logical", libNickname );
+            aWriter.Node( "uri",  m_libTable->GetFullURI( libNickname ) );
+            aWriter.EndNode();
         }
 
         // @todo: add more fun stuff here
     }
 
-    return xlibs;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
+void NETLIST_EXPORTER_GENERIC::makeLibParts( NETLIST_WRITER& aWriter )
 {
-    XNODE*      xlibparts = node( "libparts" );   // auto_ptr
-
     LIB_PINS    pinList;
     LIB_FIELDS  fieldList;
 
+    aWriter.BeginNode( "libparts" );
+
     m_libraries.clear();
 
     for( auto lcomp : m_LibParts )
@@ -397,47 +447,47 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts component's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( "libpart" ) );
-        xlibpart->AddAttribute( "lib", libNickname );
-        xlibpart->AddAttribute( "part", lcomp->GetName()  );
+        aWriter.BeginNode( "libpart" );
+        aWriter.Attribute( "lib", libNickname );
+        aWriter.Attribute( "part", lcomp->GetName()  );
 
         //----- show the important properties -------------------------
         if( !lcomp->GetDescription().IsEmpty() )
-            xlibpart->AddChild( node( "description", lcomp->GetDescription() ) );
+            aWriter.Node( "description", lcomp->GetDescription() );
 
         if( !lcomp->GetDocFileName().IsEmpty() )
-            xlibpart->AddChild( node( "docs",  lcomp->GetDocFileName() ) );
+            aWriter.Node( "docs",  lcomp->GetDocFileName() );
 
         // Write the footprint list
         if( lcomp->GetFootprints().GetCount() )
         {
-            XNODE*  xfootprints;
-            xlibpart->AddChild( xfootprints = node( "footprints" ) );
+            aWriter.BeginNode( "footprints" );
 
             for( unsigned i=0; i<lcomp->GetFootprints().GetCount(); ++i )
-            {
-                xfootprints->AddChild( node( "fp", lcomp->GetFootprints()[i] ) );
-            }
+                aWriter.Node( "fp", lcomp->GetFootprints()[i] );
+
+            aWriter.EndNode();
         }
 
         //----- show the fields here ----------------------------------
         fieldList.clear();
         lcomp->GetFields( fieldList );
 
-        XNODE*     xfields;
-        xlibpart->AddChild( xfields = node( "fields" ) );
+        aWriter.BeginNode( "fields" );
 
         for( unsigned i=0;  i<fieldList.size();  ++i )
         {
             if( !fieldList[i].GetText().IsEmpty() )
             {
-                XNODE*     xfield;
-                xfields->AddChild( xfield = node( "field", fieldList[i].GetText() ) );
-                xfield->AddAttribute( "name", fieldList[i].GetName(false) );
+                aWriter.BeginNode( "field" );
+                aWriter.Attribute( "name", fieldList[i].GetName(false) );
+                aWriter.Content( fieldList[i].GetText() );
+                aWriter.EndNode();
             }
         }
 
+        aWriter.EndNode();
+
         //----- show the pins here ------------------------------------
         pinList.clear();
         lcomp->GetPins( pinList, 0, 0 );
@@ -462,35 +512,35 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
         if( pinList.size() )
         {
-            XNODE*     pins;
+            aWriter.BeginNode( "pins" );
 
-            xlibpart->AddChild( pins = node( "pins" ) );
             for( unsigned i=0; i<pinList.size();  ++i )
             {
-                XNODE*     pin;
-
-                pins->AddChild( pin = node( "pin" ) );
-                pin->AddAttribute( "num", pinList[i]->GetNumber() );
-                pin->AddAttribute( "name", pinList[i]->GetName() );
-                pin->AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aWriter.BeginNode( "pin" );
+                aWriter.Attribute( "num", pinList[i]->GetNumber() );
+                aWriter.Attribute( "name", pinList[i]->GetName() );
+                aWriter.Attribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aWriter.EndNode();
 
                 // caution: construction work site here, drive slowly
             }
+
+            aWriter.EndNode();
         }
+
+        aWriter.EndNode();      // libpart
     }
 
-    return xlibparts;
+    aWriter.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
+void NETLIST_EXPORTER_GENERIC::makeListOfNets( NETLIST_WRITER& aWriter, bool aUseGraph )
 {
-    XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
     wxString    netName;
     wxString    ref;
 
-    XNODE*      xnet = 0;
     int         netCode;
     int         lastNetCode = -1;
     int         sameNetcodeCount = 0;
@@ -503,33 +553,50 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
         </net>
     */
 
+    aWriter.BeginNode( "nets" );
+
     m_LibParts.clear();     // must call this function before using m_LibParts.
 
     if( aUseGraph )
     {
         wxASSERT( m_graph );
 
+        // A component's reference only depends on its sheet path, so each one is only
+        // looked up once instead of once per pin.
+        std::map<std::pair<const SCH_COMPONENT*, wxString>, wxString> refs;
+
         for( const auto& it : m_graph->m_net_code_to_subgraphs_map )
         {
             bool added = false;
 
             auto code = it.first;
-            auto subgraphs = it.second;
-            auto net_name = subgraphs[0]->GetNetName();
-
-            XNODE* xnode;
+            const auto& subgraphs = it.second;
+            const auto& net_name = subgraphs[0]->GetNetName();
 
             for( auto subgraph : subgraphs )
             {
-                auto sheet = subgraph->m_sheet;
+                const SCH_SHEET_PATH& sheet = subgraph->m_sheet;
+                wxString              sheetPath;
 
                 for( auto item : subgraph->m_items )
                 {
                     if( item->Type() == SCH_PIN_T )
                     {
                         auto pin = static_cast<SCH_PIN*>( item );
+                        SCH_COMPONENT* comp = pin->GetParentComponent();
+
+                        if( sheetPath.IsEmpty() )
+                            sheetPath = sheet.Path();
 
-                        auto refText = pin->GetParentComponent()->GetRef( &sheet );
+                        auto refIt = refs.find( std::make_pair( comp, sheetPath ) );
+
+                        if( refIt == refs.end() )
+                        {
+                            refIt = refs.emplace( std::make_pair( comp, sheetPath ),
+                                                  comp->GetRef( &sheet ) ).first;
+                        }
+
+                        const wxString& refText = refIt->second;
                         const auto& pinText = pin->GetNumber();
 
                         // Skip power symbols and virtual components
@@ -538,28 +605,29 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
 
                         if( !added )
                         {
-                            xnets->AddChild( xnet = node( "net" ) );
+                            aWriter.BeginNode( "net" );
                             netCodeTxt.Printf( "%d", code );
-                            xnet->AddAttribute( "code", netCodeTxt );
-                            xnet->AddAttribute( "name", net_name );
+                            aWriter.Attribute( "code", netCodeTxt );
+                            aWriter.Attribute( "name", net_name );
 
                             added = true;
                         }
 
-                        xnet->AddChild( xnode = node( "node" ) );
-                        xnode->AddAttribute( "ref", refText );
-                        xnode->AddAttribute( "pin", pinText );
-
-                        wxString pinName;
+                        aWriter.BeginNode( "node" );
+                        aWriter.Attribute( "ref", refText );
+                        aWriter.Attribute( "pin", pinText );
 
-                        if( pin->GetName() != "~" ) //  ~ is a char used to code empty strings in libs.
-                            pinName = pin->GetName();
+                        //  ~ is a char used to code empty strings in libs.
+                        if( pin->GetName() != "~" && !pin->GetName().IsEmpty() )
+                            aWriter.Attribute( "pinfunction", pin->GetName() );
 
-                        if( !pinName.IsEmpty() )
-                            xnode->AddAttribute( "pinfunction", pinName );
+                        aWriter.EndNode();
                     }
                 }
             }
+
+            if( added )
+                aWriter.EndNode();
         }
     }
     else
@@ -572,6 +640,9 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
             // New net found, write net id;
             if( ( netCode = nitem->GetNet() ) != lastNetCode )
             {
+                if( sameNetcodeCount > 0 )
+                    aWriter.EndNode();
+
                 sameNetcodeCount = 0;   // item count for this net
                 netName = nitem->GetNetName();
                 lastNetCode  = netCode;
@@ -592,34 +663,27 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( bool aUseGraph )
 
             if( ++sameNetcodeCount == 1 )
             {
-                xnets->AddChild( xnet = node( "net" ) );
+                aWriter.BeginNode( "net" );
                 netCodeTxt.Printf( "%d", netCode );
-                xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", netName );
+                aWriter.Attribute( "code", netCodeTxt );
+                aWriter.Attribute( "name", netName );
             }
 
-            XNODE*      xnode;
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", ref );
-            xnode->AddAttribute( "pin",  nitem->GetPinNumText() );
+            aWriter.BeginNode( "node" );
+            aWriter.Attribute( "ref", ref );
+            aWriter.Attribute( "pin",  nitem->GetPinNumText() );
 
             if( !nitem->GetPinNameText().IsEmpty() )
-                xnode->AddAttribute( "pinfunction", nitem->GetPinNameText() );
-        }
-    }
-
-    return xnets;
-}
-
+                aWriter.Attribute( "pinfunction", nitem->GetPinNameText() );
 
-XNODE* NETLIST_EXPORTER_GENERIC::node( const wxString& aName, const wxString& aTextualContent /* = wxEmptyString*/ )
-{
-    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+            aWriter.EndNode();
+        }
 
-    if( aTextualContent.Len() > 0 )     // excludes wxEmptyString, the parameter's default value
-        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aTextualContent ) );
+        if( sameNetcodeCount > 0 )
+            aWriter.EndNode();
+    }
 
-    return n;
+    aWriter.EndNode();
 }
 
 
@@ -52,6 +52,41 @@ enum GNL_T
 };
 
 
+/**
+ * Class NETLIST_WRITER
+ * receives the netlist document from NETLIST_EXPORTER_GENERIC one element at a time, in
+ * document order.  Implementations can build a tree from it or stream it straight out.
+ */
+class NETLIST_WRITER
+{
+public:
+    virtual ~NETLIST_WRITER() {}
+
+    /// Open a new element, nested in the currently open one if any.
+    virtual void BeginNode( const char* aName ) = 0;
+
+    /// Add an attribute to the open element.  Attributes come before any content or children.
+    virtual void Attribute( const char* aName, const wxString& aValue ) = 0;
+
+    /// Add textual content to the open element.
+    virtual void Content( const wxString& aText ) = 0;
+
+    /// Close the open element.
+    virtual void EndNode() = 0;
+
+    /// Write an element holding only the optional text @a aTextualContent.
+    void Node( const char* aName, const wxString& aTextualContent = wxEmptyString )
+    {
+        BeginNode( aName );
+
+        if( aTextualContent.Len() > 0 )
+            Content( aTextualContent );
+
+        EndNode();
+    }
+};
+
+
 /**
  * Class NETLIST_EXPORTER_GENERIC
  * generates a generic XML based netlist file. This allows using XSLT or other methods to
@@ -85,63 +120,49 @@ public:
 #define GNL_ALL     ( GNL_LIBRARIES | GNL_COMPONENTS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
 protected:
-   /**
-     * Function node
-     * is a convenience function that creates a new XNODE with an optional textual child.
-     * It also provides some insulation from a possible change in XML library.
-     *
-     * @param aName is the name to associate with a new node of type wxXML_ELEMENT_NODE.
-     * @param aTextualContent is optional, and if given is the text to include in a child
-     *   of the returned node, and has type wxXML_TEXT_NODE.
-     */
-    XNODE* node( const wxString& aName, const wxString& aTextualContent = wxEmptyString );
-
     /**
-     * Function makeGenericRoot
-     * builds the entire document tree for the generic export.  This is factored
-     * out here so we can write the tree in either S-expression file format
-     * or in XML if we put the tree built here into a wxXmlDocument.
+     * Function makeRoot
+     * writes the entire document for the generic export.  This is factored
+     * out here so we can write the document in either S-expression file format
+     * or in XML depending on @a aWriter.
+     * @param aWriter - the destination of the document elements
      * @param aCtl - a bitset or-ed together from GNL_ENUM values
-     * @return XNODE* - the root nodes
      */
-    XNODE* makeRoot( int aCtl = GNL_ALL );
+    void makeRoot( NETLIST_WRITER& aWriter, int aCtl = GNL_ALL );
 
     /**
      * Function makeComponents
-     * @return XNODE* - returns a sub-tree holding all the schematic components.
+     * writes a sub-tree holding all the schematic components.
      */
-    XNODE* makeComponents();
+    void makeComponents( NETLIST_WRITER& aWriter );
 
     /**
      * Function makeDesignHeader
-     * fills out a project "design" header into an XML node.
-     * @return XNODE* - the design header
+     * writes a project "design" header.
      */
-    XNODE* makeDesignHeader();
+    void makeDesignHeader( NETLIST_WRITER& aWriter );
 
     /**
      * Function makeLibParts
-     * fills out an XML node with the unique library parts and returns it.
-     * @return XNODE* - the library parts nodes
+     * writes the unique library parts.
      */
-    XNODE* makeLibParts();
+    void makeLibParts( NETLIST_WRITER& aWriter );
 
     /**
      * Function makeListOfNets
-     * fills out an XML node with a list of nets and returns it.
-     * @return XNODE* - the list of nets nodes
+     * writes the list of nets.
      */
-    XNODE* makeListOfNets( bool aUseGraph = true );
+    void makeListOfNets( NETLIST_WRITER& aWriter, bool aUseGraph = true );
 
     /**
      * Function makeLibraries
-     * fills out an XML node with a list of used libraries and returns it.
-     * Must have called makeGenericLibParts() before this function.
-     * @return XNODE* - the library nodes
+     * writes the list of used libraries.
+     * Must have called makeLibParts() before this function.
      */
-    XNODE* makeLibraries();
+    void makeLibraries( NETLIST_WRITER& aWriter );
 
-    void addComponentFields(  XNODE* xcomp, SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet );
+    void addComponentFields( NETLIST_WRITER& aWriter, SCH_COMPONENT* comp,
+                             SCH_SHEET_PATH* aSheet );
 };
 
 #endif
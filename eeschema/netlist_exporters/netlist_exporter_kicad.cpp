@@ -30,10 +30,53 @@
 #include <confirm.h>
 
 #include <sch_edit_frame.h>
-#include <xnode.h>
 #include <connection_graph.h>
 #include "netlist_exporter_kicad.h"
 
+
+/**
+ * A #NETLIST_WRITER which prints the netlist as an S-expression straight to an
+ * #OUTPUTFORMATTER, in the same layout XNODE::Format() uses, without building a tree first.
+ */
+class SEXPR_NETLIST_WRITER : public NETLIST_WRITER
+{
+public:
+    SEXPR_NETLIST_WRITER( OUTPUTFORMATTER* aOut ) :
+        m_out( aOut ),
+        m_nestLevel( 0 )
+    {}
+
+    void BeginNode( const char* aName ) override
+    {
+        // Every child starts on its own line, the closing parentheses stay on the last one.
+        if( m_nestLevel > 0 )
+            m_out->Print( 0, "\n" );
+
+        m_out->Print( m_nestLevel++, "(%s", aName );
+    }
+
+    void Attribute( const char* aName, const wxString& aValue ) override
+    {
+        m_out->Print( 0, " (%s %s)", aName, m_out->Quotew( aValue ).c_str() );
+    }
+
+    void Content( const wxString& aText ) override
+    {
+        m_out->Print( 0, " %s", m_out->Quotew( aText ).c_str() );
+    }
+
+    void EndNode() override
+    {
+        m_out->Print( 0, ")" );
+        m_nestLevel--;
+    }
+
+private:
+    OUTPUTFORMATTER* m_out;
+    int              m_nestLevel;
+};
+
+
 bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
     wxASSERT( m_graph );
@@ -60,7 +103,7 @@ void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    SEXPR_NETLIST_WRITER writer( aOut );
 
-    xroot->Format( aOut, 0 );
+    makeRoot( writer, aCtl );
 }
@@ -32,6 +32,9 @@
 #define NETLIST_OBJECT_H
 
 
+#include <unordered_map>
+#include <vector>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>
 #include <sch_item.h>
@@ -306,6 +309,16 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    // Used in intermediate calculation: spatial hash of the items of the sheet being
+    // connected.  The items by end point, and the wire and bus segments by grid cell.
+    std::unordered_map<wxPoint, std::vector<unsigned>> m_itemsAtPos;
+    std::unordered_map<wxPoint, std::vector<unsigned>> m_segmentsInCell;
+
+    // Used in intermediate calculation: the net codes and bus net codes merged while
+    // connecting items by position, as a union-find forest indexed by net code.
+    std::vector<int> m_netCodeParents;
+    std::vector<int> m_busNetCodeParents;
+
 public:
     /**
      * Constructor.
@@ -469,16 +482,37 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Fill m_itemsAtPos and m_segmentsInCell with the items of the sheet starting at
+     * index \a aStart.  The list of objects is expected sorted by sheets.
+     */
+    void buildSheetIndex( unsigned aStart );
+
+    /**
+     * Return the current net code (or bus net code if \a aIsBus) of the items which were
+     * given \a aNetCode, while items are being connected by position.
+     */
+    int findNetCode( int aNetCode, bool aIsBus );
+
+    /**
+     * Merge the net (or bus net) \a aOldNetCode into \a aNewNetCode, while items are being
+     * connected by position.  This is propagateNetCode() without touching the items.
+     */
+    void mergeNetCodes( int aOldNetCode, int aNewNetCode, bool aIsBus );
+
+    /**
+     * Search connections between the end points of \a aRef and the end points of the
+     * other items of its sheet, using m_itemsAtPos.
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * The segments are searched in m_segmentsInCell, i.e. on the junction's sheet.
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus );
 
 
     /**
@@ -93,14 +93,18 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    // Items are connected by position using a spatial hash of the current sheet, and
+    // the net codes merged on the way are only resolved once all the sheets are done.
+    buildSheetIndex( 0 );
+
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
 
         if( net_item->m_SheetPath != *sheet )   // Sheet change
         {
             sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            buildSheetIndex( ii );
         }
 
         switch( net_item->m_Type )
@@ -124,7 +128,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_JUNCTION:
@@ -135,7 +139,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
 
             // Control of the junction, on BUS.
             if( net_item->m_BusNetCode == 0 )
@@ -144,7 +148,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_LABEL:
@@ -157,7 +161,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -172,7 +176,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
@@ -185,11 +189,22 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
         }
     }
 
+    for( NETLIST_OBJECT* net_item : *this )
+    {
+        net_item->SetNet( findNetCode( net_item->GetNet(), IS_WIRE ) );
+        net_item->m_BusNetCode = findNetCode( net_item->m_BusNetCode, IS_BUS );
+    }
+
+    m_itemsAtPos.clear();
+    m_segmentsInCell.clear();
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -588,68 +603,117 @@ void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bo
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+/**
+ * Size, in internal units, of the grid cells the wire and bus segments of a sheet
+ * are hashed into by buildSheetIndex().
+ */
+#define SEGMENT_INDEX_CELL_SIZE 500
+
+
+static int segmentIndexCell( int aCoord )
 {
-    int netCode;
+    // Round toward minus infinity, so that negative coordinates get their own cells.
+    return aCoord >= 0 ? aCoord / SEGMENT_INDEX_CELL_SIZE
+                       : -( ( -aCoord - 1 ) / SEGMENT_INDEX_CELL_SIZE ) - 1;
+}
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+
+void NETLIST_OBJECT_LIST::buildSheetIndex( unsigned aStart )
+{
+    m_itemsAtPos.clear();
+    m_segmentsInCell.clear();
+
+    const SCH_SHEET_PATH& sheet = GetItem( aStart )->m_SheetPath;
+
+    for( unsigned i = aStart; i < size() && GetItem( i )->m_SheetPath == sheet; i++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* item = GetItem( i );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        m_itemsAtPos[ item->m_Start ].push_back( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
+        if( item->m_End != item->m_Start )
+            m_itemsAtPos[ item->m_End ].push_back( i );
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
+        if( item->m_Type != NET_SEGMENT && item->m_Type != NET_BUS )
+            continue;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
+        int xmin = segmentIndexCell( std::min( item->m_Start.x, item->m_End.x ) );
+        int xmax = segmentIndexCell( std::max( item->m_Start.x, item->m_End.x ) );
+        int ymin = segmentIndexCell( std::min( item->m_Start.y, item->m_End.y ) );
+        int ymax = segmentIndexCell( std::max( item->m_Start.y, item->m_End.y ) );
+
+        for( int x = xmin; x <= xmax; x++ )
+        {
+            for( int y = ymin; y <= ymax; y++ )
+                m_segmentsInCell[ wxPoint( x, y ) ].push_back( i );
         }
     }
-    else    // Object type BUS, BUSLABELS, and junctions.
+}
+
+
+int NETLIST_OBJECT_LIST::findNetCode( int aNetCode, bool aIsBus )
+{
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
+
+    if( aNetCode >= (int) parents.size() )
     {
-        netCode = aRef->m_BusNetCode;
+        int first = parents.size();
 
-        for( unsigned i = start; i < size(); i++ )
+        parents.resize( aNetCode + 1 );
+
+        for( int code = first; code <= aNetCode; code++ )
+            parents[code] = code;
+
+        return aNetCode;
+    }
+
+    while( parents[aNetCode] != aNetCode )
+    {
+        parents[aNetCode] = parents[ parents[aNetCode] ];
+        aNetCode = parents[aNetCode];
+    }
+
+    return aNetCode;
+}
+
+
+void NETLIST_OBJECT_LIST::mergeNetCodes( int aOldNetCode, int aNewNetCode, bool aIsBus )
+{
+    aOldNetCode = findNetCode( aOldNetCode, aIsBus );
+    aNewNetCode = findNetCode( aNewNetCode, aIsBus );
+
+    if( aOldNetCode == aNewNetCode )
+        return;
+
+    if( aIsBus )
+        m_busNetCodeParents[aOldNetCode] = aNewNetCode;
+    else
+        m_netCodeParents[aOldNetCode] = aNewNetCode;
+}
+
+
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus )
+{
+    int netCode;
+
+    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+        netCode = findNetCode( aRef->GetNet(), IS_WIRE );
+    else                     // Object type BUS, BUSLABELS, and junctions.
+        netCode = findNetCode( aRef->m_BusNetCode, IS_BUS );
+
+    for( const wxPoint& pos : { aRef->m_Start, aRef->m_End } )
+    {
+        auto candidates = m_itemsAtPos.find( pos );
+
+        if( candidates == m_itemsAtPos.end() )
+            continue;
+
+        for( unsigned i : candidates->second )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
-
             switch( item->m_Type )
             {
-            case NET_ITEM_UNSPECIFIED:
             case NET_SEGMENT:
             case NET_PIN:
             case NET_LABEL:
@@ -658,6 +722,13 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_SHEETLABEL:
             case NET_PINLABEL:
             case NET_NOCONNECT:
+                if( aIsBus )
+                    break;
+
+                if( item->GetNet() == 0 )
+                    item->SetNet( netCode );
+                else
+                    mergeNetCodes( item->GetNet(), netCode, IS_WIRE );
                 break;
 
             case NET_BUS:
@@ -665,35 +736,57 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_SHEETBUSLABELMEMBER:
             case NET_HIERBUSLABELMEMBER:
             case NET_GLOBBUSLABELMEMBER:
+                if( !aIsBus )
+                    break;
+
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = netCode;
+                else
+                    mergeNetCodes( item->m_BusNetCode, netCode, IS_BUS );
+                break;
+
             case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
+                if( aIsBus == IS_WIRE )
+                {
+                    if( item->GetNet() == 0 )
+                        item->SetNet( netCode );
+                    else
+                        mergeNetCodes( item->GetNet(), netCode, IS_WIRE );
+                }
+                else
                 {
                     if( item->m_BusNetCode == 0 )
                         item->m_BusNetCode = netCode;
                     else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
+                        mergeNetCodes( item->m_BusNetCode, netCode, IS_BUS );
                 }
                 break;
+
+            case NET_ITEM_UNSPECIFIED:
+                break;
             }
         }
+
+        if( aRef->m_End == aRef->m_Start )
+            break;
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    // A segment going through the junction necessarily covers the junction's cell.
+    wxPoint cell( segmentIndexCell( aJonction->m_Start.x ),
+                  segmentIndexCell( aJonction->m_Start.y ) );
+    auto candidates = m_segmentsInCell.find( cell );
+
+    if( candidates == m_segmentsInCell.end() )
+        return;
+
+    for( unsigned i : candidates->second )
     {
         NETLIST_OBJECT* segment = GetItem( i );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
         if( aIsBus == IS_WIRE )
         {
             if( segment->m_Type != NET_SEGMENT )
@@ -711,16 +804,16 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
             if( aIsBus == IS_WIRE )
             {
                 if( segment->GetNet() )
-                    propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
+                    mergeNetCodes( segment->GetNet(), aJonction->GetNet(), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    segment->SetNet( findNetCode( aJonction->GetNet(), aIsBus ) );
             }
             else
             {
                 if( segment->m_BusNetCode )
-                    propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
+                    mergeNetCodes( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    segment->m_BusNetCode = findNetCode( aJonction->m_BusNetCode, aIsBus );
             }
         }
     }
@@ -365,6 +365,10 @@ void SCH_BASE_FRAME::RefreshItem( EDA_ITEM* aItem, bool isAddOrDelete )
 {
     EDA_ITEM* parent = aItem->GetParent();
 
+    // Keep the spatial index of the screen in sync with the item geometry.
+    if( !isAddOrDelete && dynamic_cast<SCH_ITEM*>( aItem ) )
+        GetScreen()->Update( static_cast<SCH_ITEM*>( aItem ) );
+
     if( aItem->Type() == SCH_SHEET_PIN_T )
     {
         // Sheet pins aren't in the view.  Refresh their parent.
@@ -464,6 +464,9 @@ void SCH_COMPONENT::UpdatePins( SCH_SHEET_PATH* aSheet )
     m_pins.clear();
     m_pinMap.clear();
 
+    // The pins are new objects: they must be linked again by the connection graph
+    SetConnectivityDirty();
+
     if( m_part )
     {
         unsigned i = 0;
@@ -1038,8 +1038,11 @@ public:
 
     /**
      * Generates the connection data for the entire schematic hierarchy.
+     *
+     * @param aIncremental only links again the items of the sheets modified since the last
+     *                     calculation (see CONNECTION_GRAPH::Recalculate()).
      */
-    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags );
+    void RecalculateConnections( SCH_CLEANUP_FLAGS aCleanupFlags, bool aIncremental = false );
 
     /**
      * Allows Eeschema to install its preferences panels into the preferences dialog.
@@ -21,8 +21,10 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/join.hpp>
 #include <cctype>
+#include <functional>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -461,14 +463,47 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
 }
 
 
+/**
+ * A #FILE_LINE_READER that remembers the file offset of the current line so a section of a
+ * library file can be read again later without parsing everything in front of it.
+ */
+class SYMBOL_LIB_LINE_READER : public FILE_LINE_READER
+{
+public:
+    SYMBOL_LIB_LINE_READER( const wxString& aFileName ) :
+        FILE_LINE_READER( aFileName ),
+        m_lineOffset( 0 )
+    {
+    }
+
+    char* ReadLine() override
+    {
+        m_lineOffset = ftell( m_fp );
+        return FILE_LINE_READER::ReadLine();
+    }
+
+    /// @return the file offset of the start of the current line.
+    long LineOffset() const { return m_lineOffset; }
+
+private:
+    long m_lineOffset;
+};
+
+
 /**
  * A cache assistant for the part library portion of the #SCH_PLUGIN API, and only for the
  * #SCH_LEGACY_PLUGIN, so therefore is private to this implementation file, i.e. not placed
  * into a header.
+ *
+ * Loading a library only builds an index of the symbols it contains: the name, aliases,
+ * fields, footprint filters and documentation of each symbol.  The draw items (pins and
+ * graphics) of a symbol are parsed the first time the symbol itself is requested.
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    // Keep track of the modification status of the library.  Atomic because the libraries
+    // are loaded on the symbol chooser worker threads.
+    static std::atomic<int> m_modHash;
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -480,12 +515,17 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
+    // File offset and line number of the DRAW section of the root symbols whose draw items
+    // have not been loaded yet.
+    std::map<const LIB_PART*, std::pair<long, unsigned>> m_deferredDrawEntries;
+
     void                  loadHeader( FILE_LINE_READER& aReader );
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
                                        LIB_PART_MAP* aMap = nullptr );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadDrawEntries( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
                                            int aMajorVersion, int aMinorVersion );
+    static void           skipDrawEntries( LINE_READER& aReader );
     static void           loadFootprintFilters( std::unique_ptr<LIB_PART>& aPart,
                                                 LINE_READER& aReader );
     void                  loadDocs();
@@ -534,6 +574,17 @@ public:
 
     void DeleteSymbol( const wxString& aName );
 
+    /**
+     * Load the draw items of \a aPart, or of its parent when \a aPart is an alias, if they
+     * were deferred when the library was loaded.
+     *
+     * @throw IO_ERROR if the library file cannot be read or the draw items cannot be parsed.
+     */
+    void LoadDrawItems( LIB_PART* aPart );
+
+    /// Load the deferred draw items of every symbol in the library.
+    void LoadAllDrawItems();
+
     // If m_libFileName is a symlink follow it to the real source file
     wxFileName GetRealFile() const;
 
@@ -551,8 +602,16 @@ public:
 
     wxString GetFileName() const { return m_libFileName.GetFullPath(); }
 
+    /**
+     * Parse a DEF/ENDDEF symbol definition.
+     *
+     * @param aDeferDrawEntries, if set, is called with the part when its DRAW section is the
+     *        current line of \a aReader.  The section is then skipped rather than parsed.
+     */
     static LIB_PART* LoadPart( LINE_READER& aReader, int aMajorVersion, int aMinorVersion,
-                               LIB_PART_MAP* aMap = nullptr );
+                               LIB_PART_MAP* aMap = nullptr,
+                               const std::function<void( LIB_PART* )>& aDeferDrawEntries =
+                                       nullptr );
     static void      SaveSymbol( LIB_PART* aSymbol, OUTPUTFORMATTER& aFormatter,
                                  LIB_PART_MAP* aMap = nullptr );
 };
@@ -2312,7 +2371,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2336,6 +2395,7 @@ SCH_LEGACY_PLUGIN_CACHE::~SCH_LEGACY_PLUGIN_CACHE()
         delete it->second;
 
     m_symbols.clear();
+    m_deferredDrawEntries.clear();
 }
 
 
@@ -2412,6 +2472,9 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
     // the root part and make it the new root.
     if( aPart->IsRoot() )
     {
+        // The draw items are copied to the new root below.
+        LoadDrawItems( aPart );
+
         for( auto entry : m_symbols )
         {
             if( entry.second->IsAlias()
@@ -2450,6 +2513,7 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
     }
 
     m_symbols.erase( it );
+    m_deferredDrawEntries.erase( aPart );
     delete aPart;
     m_isModified = true;
     ++m_modHash;
@@ -2489,7 +2553,7 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    SYMBOL_LIB_LINE_READER reader( m_libFileName.GetFullPath() );
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
@@ -2543,8 +2607,15 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 
         if( strCompare( "DEF", line ) )
         {
-            // Read one DEF/ENDDEF part entry from library:
-            LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &m_symbols );
+            // Read one DEF/ENDDEF part entry from library, leaving the draw items for later:
+            LIB_PART* part = LoadPart( reader, m_versionMajor, m_versionMinor, &m_symbols,
+                    [&]( LIB_PART* aPart )
+                    {
+                        // Number the lines from the DRAW line so error messages still
+                        // match the file.
+                        m_deferredDrawEntries[ aPart ] = std::make_pair( reader.LineOffset(),
+                                                                         reader.LineNumber() - 1 );
+                    } );
 
             m_symbols[ part->GetName() ] = part;
         }
@@ -2562,6 +2633,73 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 }
 
 
+void SCH_LEGACY_PLUGIN_CACHE::LoadDrawItems( LIB_PART* aPart )
+{
+    wxCHECK_RET( aPart, "Cannot load the draw items of a NULL symbol." );
+
+    LIB_PART* root = aPart;
+
+    if( aPart->IsAlias() )
+    {
+        std::shared_ptr< LIB_PART > parent = aPart->GetParent().lock();
+
+        wxCHECK_RET( parent, "Symbol \"" + aPart->GetName() + "\" has no parent." );
+
+        root = parent.get();
+    }
+
+    auto it = m_deferredDrawEntries.find( root );
+
+    if( it == m_deferredDrawEntries.end() )
+        return;
+
+    long     offset = it->second.first;
+    unsigned lineNumber = it->second.second;
+
+    // Only try once, a section that failed to parse will not parse any better next time.
+    m_deferredDrawEntries.erase( it );
+
+    wxLogTrace( traceSchLegacyPlugin, "Loading draw items of symbol \"%s\" from \"%s\"",
+                root->GetName(), m_fileName );
+
+    FILE* fp = wxFopen( m_fileName, wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open library file \"%s\"." ),
+                                          m_fileName ) );
+
+    FILE_LINE_READER reader( fp, m_fileName, true, lineNumber );
+
+    if( fseek( fp, offset, SEEK_SET ) != 0 || !reader.ReadLine() )
+        THROW_IO_ERROR( wxString::Format( _( "Unexpected end of library file \"%s\"." ),
+                                          m_fileName ) );
+
+    LOCALE_IO toggle;     // toggles on, then off, the C locale.
+
+    // loadDrawEntries() adds the items to the part it is given but never deletes it.
+    std::unique_ptr< LIB_PART > part( root );
+
+    try
+    {
+        loadDrawEntries( part, reader, m_versionMajor, m_versionMinor );
+    }
+    catch( ... )
+    {
+        part.release();
+        throw;
+    }
+
+    part.release();
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::LoadAllDrawItems()
+{
+    while( !m_deferredDrawEntries.empty() )
+        LoadDrawItems( const_cast< LIB_PART* >( m_deferredDrawEntries.begin()->first ) );
+}
+
+
 void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 {
     const char* line;
@@ -2689,7 +2827,8 @@ void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
 
 
 LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVersion,
-                                             int aMinorVersion, LIB_PART_MAP* aMap )
+                                             int aMinorVersion, LIB_PART_MAP* aMap,
+                                             const std::function<void( LIB_PART* )>& aDeferDrawEntries )
 {
     const char* line = aReader.Line();
 
@@ -2846,7 +2985,17 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVer
         else if( *line == 'F' )                             // Fields
             loadField( part, aReader );
         else if( strCompare( "DRAW", line, &line ) )        // Drawing objects.
-            loadDrawEntries( part, aReader, aMajorVersion, aMinorVersion );
+        {
+            if( aDeferDrawEntries )
+            {
+                aDeferDrawEntries( part.get() );
+                skipDrawEntries( aReader );
+            }
+            else
+            {
+                loadDrawEntries( part, aReader, aMajorVersion, aMinorVersion );
+            }
+        }
         else if( strCompare( "$FPLIST", line, &line ) )     // Footprint filter list
             loadFootprintFilters( part, aReader );
         else if( strCompare( "ENDDEF", line, &line ) )      // End of part description
@@ -3102,6 +3251,22 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
+void SCH_LEGACY_PLUGIN_CACHE::skipDrawEntries( LINE_READER& aReader )
+{
+    const char* line = aReader.Line();
+
+    wxCHECK_RET( strCompare( "DRAW", line, &line ), "Invalid DRAW section" );
+
+    while( ( line = aReader.ReadLine() ) != nullptr )
+    {
+        if( strCompare( "ENDDRAW", line, &line ) )
+            return;
+    }
+
+    SCH_PARSE_ERROR( "file ended prematurely loading component draw element", aReader, line );
+}
+
+
 FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( LINE_READER& aReader, const char* aLine,
                                                const char** aOutput )
 {
@@ -3612,6 +3777,9 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // The deferred draw items are read from the file about to be overwritten.
+    LoadAllDrawItems();
+
     // Write through symlinks, don't replace them
     wxFileName fn = GetRealFile();
 
@@ -4169,6 +4337,7 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
             }
         }
 
+        m_deferredDrawEntries.erase( rootPart );
         delete rootPart;
     }
     else
@@ -4261,6 +4430,8 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 
     bool powerSymbolsOnly = ( aProperties &&
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
+    bool noDrawItems = ( aProperties &&
+                         aProperties->find( SYMBOL_LIB_TABLE::PropNoDrawItems ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
@@ -4268,7 +4439,12 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
     {
         if( !powerSymbolsOnly || it->second->IsPower() )
+        {
+            if( !noDrawItems )
+                m_cache->LoadDrawItems( it->second );
+
             aSymbolList.push_back( it->second );
+        }
     }
 }
 
@@ -4287,6 +4463,8 @@ LIB_PART* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxS
     if( it == m_cache->m_symbols.end() )
         return nullptr;
 
+    m_cache->LoadDrawItems( it->second );
+
     return it->second;
 }
 
@@ -0,0 +1,142 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef EESCHEMA_SCH_RTREE_H_
+#define EESCHEMA_SCH_RTREE_H_
+
+#include <functional>
+#include <unordered_map>
+
+#include <eda_rect.h>
+#include <geometry/rtree.h>
+
+class SCH_ITEM;
+
+
+/**
+ * Class EE_RTREE -
+ * Implements an R-tree for fast spatial indexing of the items of a schematic screen.
+ * Non-owning.  The bounding box of each item is given by the caller, so it can be made
+ * large enough to contain the item children (fields, sheet pins) and connection points.
+ * The box used to insert an item is remembered, so the item can be removed after it was
+ * moved.
+ */
+class EE_RTREE
+{
+public:
+
+    EE_RTREE()
+    {
+        m_tree = new RTree<SCH_ITEM*, int, 2, double>();
+    }
+
+    ~EE_RTREE()
+    {
+        delete m_tree;
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item into the tree with the bounding box \a aBBox.  An item already
+     * in the tree is moved to \a aBBox.
+     */
+    void Insert( SCH_ITEM* aItem, EDA_RECT aBBox )
+    {
+        Remove( aItem );
+
+        aBBox.Normalize();
+
+        const int mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        m_tree->Insert( mmin, mmax, aItem );
+        m_boxes[ aItem ] = aBBox;
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item from the tree.  Removal is done by comparing pointers.
+     * @return true if the item was found in the tree
+     */
+    bool Remove( SCH_ITEM* aItem )
+    {
+        auto it = m_boxes.find( aItem );
+
+        if( it == m_boxes.end() )
+            return false;
+
+        const EDA_RECT& bbox = it->second;
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_tree->Remove( mmin, mmax, aItem );
+        m_boxes.erase( it );
+
+        return true;
+    }
+
+    /**
+     * Function Contains()
+     * @return true if \a aItem is in the tree
+     */
+    bool Contains( SCH_ITEM* aItem ) const
+    {
+        return m_boxes.count( aItem ) > 0;
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the RTree
+     */
+    void RemoveAll()
+    {
+        m_tree->RemoveAll();
+        m_boxes.clear();
+    }
+
+    /**
+     * Function Query()
+     * Executes \a aVisitor for each item whose bounding box intersects with \a aBounds.
+     * The visitor returns false to stop the search.
+     */
+    void Query( EDA_RECT aBounds, std::function<bool( SCH_ITEM* )> aVisitor ) const
+    {
+        aBounds.Normalize();
+
+        const int mmin[2] = { aBounds.GetX(), aBounds.GetY() };
+        const int mmax[2] = { aBounds.GetRight(), aBounds.GetBottom() };
+
+        m_tree->Search( mmin, mmax, [&aVisitor]( SCH_ITEM* const& aItem )
+                                    {
+                                        return aVisitor( aItem );
+                                    } );
+    }
+
+private:
+
+    RTree<SCH_ITEM*, int, 2, double>*        m_tree;
+    std::unordered_map<SCH_ITEM*, EDA_RECT>  m_boxes;   ///< Box each item was inserted with
+};
+
+
+#endif /* EESCHEMA_SCH_RTREE_H_ */
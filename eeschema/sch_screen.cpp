@@ -62,6 +62,7 @@
 #include <algorithm>
 #include <future>
 #include <array>
+#include <unordered_map>
 
 // TODO(JE) Debugging only
 #include <profile.h>
@@ -108,6 +109,8 @@ SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    m_rtreeValid = false;
+    m_connectivityDirty = true;
 
     SetZoom( 32 );
 
@@ -167,6 +170,11 @@ void SCH_SCREEN::Append( SCH_SCREEN* aScreen )
     // This screen owns the objects now.  This prevents the object from being delete when
     // aSheet is deleted.
     aScreen->m_drawList.SetOwnership( false );
+
+    m_rtreeValid = false;
+    aScreen->m_rtreeValid = false;
+    m_connectivityDirty = true;
+    aScreen->m_connectivityDirty = true;
 }
 
 
@@ -184,12 +192,94 @@ void SCH_SCREEN::Clear()
 void SCH_SCREEN::FreeDrawList()
 {
     m_drawList.DeleteAll();
+    m_rtree.RemoveAll();
+    m_rtreeValid = false;
+    m_connectivityDirty = true;
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     m_drawList.Remove( aItem );
+    m_rtree.Remove( aItem );
+    m_connectivityDirty = true;
+}
+
+
+void SCH_SCREEN::Update( SCH_ITEM* aItem )
+{
+    m_connectivityDirty = true;
+
+    if( !m_rtreeValid || !aItem )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case SCH_SHEET_PIN_T:
+    case SCH_FIELD_T:
+    case SCH_PIN_T:
+        // Owned items are indexed with their parent.
+        aItem = dynamic_cast<SCH_ITEM*>( aItem->GetParent() );
+
+        if( !aItem )
+            return;
+
+        break;
+
+    default:
+        break;
+    }
+
+    if( m_rtree.Contains( aItem ) )
+        m_rtree.Insert( aItem, indexBoundingBox( aItem ) );
+}
+
+
+EDA_RECT SCH_SCREEN::indexBoundingBox( const SCH_ITEM* aItem )
+{
+    EDA_RECT bbox = aItem->GetBoundingBox();
+    std::vector< wxPoint > points;
+
+    bbox.Normalize();
+
+    if( aItem->Type() == SCH_SHEET_T )
+    {
+        for( const SCH_SHEET_PIN& pin : static_cast<const SCH_SHEET*>( aItem )->GetPins() )
+            bbox.Merge( pin.GetBoundingBox() );
+    }
+
+    aItem->GetConnectionPoints( points );
+
+    for( const wxPoint& pt : points )
+        bbox.Merge( pt );
+
+    return bbox;
+}
+
+
+void SCH_SCREEN::ensureIndex() const
+{
+    if( m_rtreeValid )
+        return;
+
+    m_rtree.RemoveAll();
+
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+        m_rtree.Insert( item, indexBoundingBox( item ) );
+
+    m_rtreeValid = true;
+}
+
+
+void SCH_SCREEN::queryItems( const wxPoint& aPosition, int aAccuracy,
+                             std::function<bool( SCH_ITEM* )> aVisitor ) const
+{
+    ensureIndex();
+
+    EDA_RECT area( aPosition, wxSize( 0, 0 ) );
+    area.Inflate( std::max( aAccuracy, 1 ) );
+
+    m_rtree.Query( area, aVisitor );
 }
 
 
@@ -206,11 +296,12 @@ void SCH_SCREEN::DeleteItem( SCH_ITEM* aItem )
         SCH_SHEET* sheet = sheetPin->GetParent();
         wxCHECK_RET( sheet, wxT( "Sheet label parent not properly set, bad programmer!" ) );
         sheet->RemovePin( sheetPin );
+        m_connectivityDirty = true;
         return;
     }
     else
     {
-        m_drawList.Remove( aItem );
+        Remove( aItem );
         delete aItem;
     }
 }
@@ -234,9 +325,10 @@ bool SCH_SCREEN::CheckIfOnDrawList( SCH_ITEM* aItem )
 
 SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) const
 {
-    KICAD_T types[] = { aType, EOT };
+    KICAD_T   types[] = { aType, EOT };
+    SCH_ITEM* found = NULL;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPosition, aAccuracy, [&]( SCH_ITEM* item )
     {
         switch( item->Type() )
         {
@@ -249,7 +341,10 @@ SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T
                 SCH_FIELD* field = component->GetField( i );
 
                 if( field->IsType( types ) && field->HitTest( aPosition, aAccuracy ) )
-                    return field;
+                {
+                    found = field;
+                    return false;
+                }
             }
 
             break;
@@ -261,7 +356,10 @@ SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T
             SCH_SHEET_PIN* pin = sheet->GetPin( aPosition );
 
             if( pin && pin->IsType( types ) )
-                return pin;
+            {
+                found = pin;
+                return false;
+            }
 
             break;
         }
@@ -270,10 +368,15 @@ SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T
         }
 
         if( item->IsType( types ) && item->HitTest( aPosition, aAccuracy ) )
-            return item;
-    }
+        {
+            found = item;
+            return false;
+        }
 
-    return NULL;
+        return true;
+    } );
+
+    return found;
 }
 
 
@@ -300,6 +403,8 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
     }
 
     m_drawList.Append( aWireList );
+    m_rtreeValid = false;
+    m_connectivityDirty = true;
 }
 
 
@@ -355,13 +460,18 @@ bool SCH_SCREEN::IsJunctionNeeded( const wxPoint& aPosition, bool aNew )
 
     std::vector<SCH_LINE*> lines[ sizeof( layers ) ];
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    bool    has_junction = false;
+
+    queryItems( aPosition, 0, [&]( SCH_ITEM* item )
     {
         if( item->GetEditFlags() & STRUCT_DELETED )
-            continue;
+            return true;
 
         if( aNew && ( item->Type() == SCH_JUNCTION_T ) && ( item->HitTest( aPosition ) ) )
+        {
+            has_junction = true;
             return false;
+        }
 
         if( ( item->Type() == SCH_LINE_T ) && ( item->HitTest( aPosition, 0 ) ) )
         {
@@ -373,7 +483,12 @@ bool SCH_SCREEN::IsJunctionNeeded( const wxPoint& aPosition, bool aNew )
 
         if( ( item->Type() == SCH_COMPONENT_T ) && ( item->IsConnected( aPosition ) ) )
             pin_count++;
-    }
+
+        return true;
+    } );
+
+    if( has_junction )
+        return false;
 
     for( int i : { WIRES, BUSSES } )
     {
@@ -514,6 +629,9 @@ void SCH_SCREEN::UpdateSymbolLinks( bool aForce )
             SCH_COMPONENT::ResolveAll( c, *libs, Prj().SchLibs()->GetCacheLibrary() );
 
             m_modification_sync = mod_hash;     // note the last mod_hash
+
+            // The symbol bodies, and so the component bounding boxes, may have changed.
+            m_rtreeValid = false;
         }
         // Resolving will update the pin caches but we must ensure that this happens
         // even if the libraries don't change.
@@ -619,14 +737,13 @@ void SCH_SCREEN::ClearDrawingState()
 LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent,
                              bool aEndPointOnly ) const
 {
-    SCH_ITEM*       item;
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPosition, 0, [&]( SCH_ITEM* item )
     {
         if( item->Type() != SCH_COMPONENT_T )
-            continue;
+            return true;
 
         component = (SCH_COMPONENT*) item;
 
@@ -635,7 +752,7 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
             pin = NULL;
 
             if( !component->GetPartRef() )
-                continue;
+                return true;
 
             for( pin = component->GetPartRef()->GetNextPin(); pin;
                  pin = component->GetPartRef()->GetNextPin( pin ) )
@@ -652,17 +769,14 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
                 if(component->GetPinPhysicalPosition( pin ) == aPosition )
                     break;
             }
-            if( pin )
-                break;
         }
         else
         {
             pin = (LIB_PIN*) component->GetDrawItem( aPosition, LIB_PIN_T );
-
-            if( pin )
-                break;
         }
-    }
+
+        return pin == NULL;
+    } );
 
     if( pin && aComponent )
         *aComponent = component;
@@ -692,17 +806,16 @@ SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 {
     SCH_SHEET_PIN* sheetPin = NULL;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPosition, 0, [&]( SCH_ITEM* item )
     {
         if( item->Type() != SCH_SHEET_T )
-            continue;
+            return true;
 
         SCH_SHEET* sheet = (SCH_SHEET*) item;
         sheetPin = sheet->GetPin( aPosition );
 
-        if( sheetPin )
-            break;
-    }
+        return sheetPin == NULL;
+    } );
 
     return sheetPin;
 }
@@ -710,17 +823,18 @@ SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 
 int SCH_SCREEN::CountConnectedItems( const wxPoint& aPos, bool aTestJunctions ) const
 {
-    SCH_ITEM* item;
     int       count = 0;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPos, 0, [&]( SCH_ITEM* item )
     {
         if( item->Type() == SCH_JUNCTION_T  && !aTestJunctions )
-            continue;
+            return true;
 
         if( item->IsConnected( aPos ) )
             count++;
-    }
+
+        return true;
+    } );
 
     return count;
 }
@@ -776,19 +890,112 @@ void SCH_SCREEN::GetHierarchicalItems( EDA_ITEMS& aItems )
 }
 
 
-bool SCH_SCREEN::TestDanglingEnds()
+bool SCH_SCREEN::TestDanglingEnds( std::function<void( SCH_ITEM* )> aChangedHandler )
 {
-    SCH_ITEM* item;
     std::vector< DANGLING_END_ITEM > endPoints;
+    std::vector< SCH_ITEM* >         items;
+    std::vector< size_t >            firstEnd;
     bool hasStateChanged = false;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    {
+        items.push_back( item );
+        firstEnd.push_back( endPoints.size() );
         item->GetEndPoints( endPoints );
+    }
+
+    firstEnd.push_back( endPoints.size() );
+
+    // Index the end points by position, and the wires and buses by their start entry.
+    std::unordered_multimap< wxPoint, size_t > endsAtPos;
+    std::unordered_map< const EDA_ITEM*, size_t > segmentStart;
+
+    endsAtPos.reserve( endPoints.size() );
+
+    for( size_t ii = 0; ii < endPoints.size(); ii++ )
+    {
+        endsAtPos.emplace( endPoints[ii].GetPosition(), ii );
+
+        if( endPoints[ii].GetType() == WIRE_START_END || endPoints[ii].GetType() == BUS_START_END )
+            segmentStart[ endPoints[ii].GetItem() ] = ii;
+    }
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    std::vector< wxPoint >           points;
+    std::vector< size_t >            candidates;
+    std::vector< DANGLING_END_ITEM > nearEnds;
+
+    // Wires and buses are stored in the list as a pair, start and end, and the items rely on
+    // finding the end right after the start.  Always add both entries of a pair.
+    auto addCandidate = [&]( size_t aIndex )
     {
-        if( item->UpdateDanglingState( endPoints ) )
+        DANGLING_END_T type = endPoints[aIndex].GetType();
+
+        if( type == WIRE_START_END || type == BUS_START_END )
+        {
+            candidates.push_back( aIndex );
+            candidates.push_back( aIndex + 1 );
+        }
+        else if( type == WIRE_END_END || type == BUS_END_END )
+        {
+            candidates.push_back( aIndex - 1 );
+            candidates.push_back( aIndex );
+        }
+        else
+        {
+            candidates.push_back( aIndex );
+        }
+    };
+
+    for( size_t ii = 0; ii < items.size(); ii++ )
+    {
+        SCH_ITEM* item = items[ii];
+
+        points.clear();
+        candidates.clear();
+        nearEnds.clear();
+
+        for( size_t jj = firstEnd[ii]; jj < firstEnd[ii + 1]; jj++ )
+            points.push_back( endPoints[jj].GetPosition() );
+
+        item->GetConnectionPoints( points );
+
+        for( const wxPoint& pt : points )
+        {
+            auto range = endsAtPos.equal_range( pt );
+
+            for( auto it = range.first; it != range.second; ++it )
+                addCandidate( it->second );
+
+            // Labels and bus entries also connect to the middle of wires and buses.
+            queryItems( pt, 0, [&]( SCH_ITEM* aLine )
+            {
+                auto seg = segmentStart.find( aLine );
+
+                if( seg != segmentStart.end()
+                        && IsPointOnSegment( endPoints[seg->second].GetPosition(),
+                                             endPoints[seg->second + 1].GetPosition(), pt ) )
+                {
+                    addCandidate( seg->second );
+                }
+
+                return true;
+            } );
+        }
+
+        // Keep the order of the full list so the result does not depend on the index.
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+        for( size_t idx : candidates )
+            nearEnds.push_back( endPoints[idx] );
+
+        if( item->UpdateDanglingState( nearEnds ) )
+        {
             hasStateChanged = true;
+
+            if( aChangedHandler )
+                aChangedHandler( item );
+        }
     }
 
     return hasStateChanged;
@@ -798,54 +1005,67 @@ bool SCH_SCREEN::TestDanglingEnds()
 SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 {
     static KICAD_T types[] = { SCH_LINE_LOCATE_WIRE_T, SCH_LINE_LOCATE_BUS_T, EOT };
+    SCH_LINE*      found = nullptr;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    queryItems( aPosition, 0, [&]( SCH_ITEM* item )
     {
         if( item->IsType( types ) && item->HitTest( aPosition ) )
-            return (SCH_LINE*) item;
-    }
+        {
+            found = (SCH_LINE*) item;
+            return false;
+        }
+
+        return true;
+    } );
 
-    return nullptr;
+    return found;
 }
 
 
 SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLayer,
                                SCH_LINE_TEST_T aSearchType )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    SCH_LINE* found = NULL;
+
+    queryItems( aPosition, aAccuracy, [&]( SCH_ITEM* item )
     {
         if( item->Type() != SCH_LINE_T )
-            continue;
+            return true;
 
         if( item->GetLayer() != aLayer )
-            continue;
+            return true;
 
         if( !item->HitTest( aPosition, aAccuracy ) )
-            continue;
+            return true;
 
         switch( aSearchType )
         {
         case ENTIRE_LENGTH_T:
-            return (SCH_LINE*) item;
+            found = (SCH_LINE*) item;
+            break;
 
         case EXCLUDE_END_POINTS_T:
             if( !( (SCH_LINE*) item )->IsEndPoint( aPosition ) )
-                return (SCH_LINE*) item;
+                found = (SCH_LINE*) item;
             break;
 
         case END_POINTS_ONLY_T:
             if( ( (SCH_LINE*) item )->IsEndPoint( aPosition ) )
-                return (SCH_LINE*) item;
+                found = (SCH_LINE*) item;
         }
-    }
 
-    return NULL;
+        return found == NULL;
+    } );
+
+    return found;
 }
 
 
 SCH_TEXT* SCH_SCREEN::GetLabel( const wxPoint& aPosition, int aAccuracy )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    SCH_TEXT* found = NULL;
+
+    queryItems( aPosition, aAccuracy, [&]( SCH_ITEM* item )
     {
         switch( item->Type() )
         {
@@ -853,14 +1073,19 @@ SCH_TEXT* SCH_SCREEN::GetLabel( const wxPoint& aPosition, int aAccuracy )
         case SCH_GLOBAL_LABEL_T:
         case SCH_HIER_LABEL_T:
             if( item->HitTest( aPosition, aAccuracy ) )
-                return (SCH_TEXT*) item;
+            {
+                found = (SCH_TEXT*) item;
+                return false;
+            }
 
         default:
             ;
         }
-    }
 
-    return NULL;
+        return true;
+    } );
+
+    return found;
 }
 
 
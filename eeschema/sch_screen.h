@@ -36,6 +36,7 @@
 #include <kiway_holder.h>
 #include <sch_marker.h>
 #include <bus_alias.h>
+#include <sch_rtree.h>
 
 
 class LIB_PIN;
@@ -88,12 +89,36 @@ private:
 
     DLIST< SCH_ITEM > m_drawList;       ///< Object list for the screen.
 
+    mutable EE_RTREE  m_rtree;          ///< Spatial index of m_drawList, built on demand.
+    mutable bool      m_rtreeValid;     ///< False when m_rtree must be rebuilt before use.
+
+    bool    m_connectivityDirty;        ///< True when items were added, removed or moved since
+                                        ///< the connectivity of the screen was last computed.
+
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
     /// List of bus aliases stored in this screen
     std::unordered_set< std::shared_ptr< BUS_ALIAS > > m_aliases;
 
+    /**
+     * @return the box used to index \a aItem: its bounding box grown to include its
+     *         sheet pins and connection points.
+     */
+    static EDA_RECT indexBoundingBox( const SCH_ITEM* aItem );
+
+    /**
+     * Rebuild the spatial index from the item list if it is not up to date.
+     */
+    void ensureIndex() const;
+
+    /**
+     * Run \a aVisitor on each item whose index box is within \a aAccuracy of
+     * \a aPosition.  The visitor returns false to stop the search.
+     */
+    void queryItems( const wxPoint& aPosition, int aAccuracy,
+                     std::function<bool( SCH_ITEM* )> aVisitor ) const;
+
 public:
 
     /**
@@ -103,7 +128,32 @@ public:
 
     ~SCH_SCREEN();
 
-    DLIST< SCH_ITEM > & GetDrawList() { return m_drawList; }
+    /**
+     * @return the item list.  Because the list can be modified through the returned
+     *         reference, the spatial index of the screen is rebuilt on its next use.
+     *         Use GetDrawItems() to only read the list.
+     */
+    DLIST< SCH_ITEM > & GetDrawList()
+    {
+        m_rtreeValid = false;
+        m_connectivityDirty = true;
+        return m_drawList;
+    }
+
+    /**
+     * Build the spatial index of the screen if it is not up to date.
+     *
+     * Building the index computes the bounding boxes of the items, which uses the shared
+     * text metrics.  Call this before the screen is queried from worker threads.
+     */
+    void BuildIndex() const { ensureIndex(); }
+
+    /**
+     * The connectivity of a screen is dirty when items were added, removed or moved since
+     * CONNECTION_GRAPH last linked its items.  Used for incremental connectivity updates.
+     */
+    bool IsConnectivityDirty() const { return m_connectivityDirty; }
+    void SetConnectivityDirty( bool aDirty = true ) { m_connectivityDirty = aDirty; }
 
     static inline bool ClassOf( const EDA_ITEM* aItem )
     {
@@ -155,6 +205,10 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+        m_connectivityDirty = true;
+
+        if( m_rtreeValid )
+            m_rtree.Insert( aItem, indexBoundingBox( aItem ) );
     }
 
     /**
@@ -178,8 +232,19 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        m_rtreeValid = false;
+        m_connectivityDirty = true;
     }
 
+    /**
+     * Update the spatial index entry of \a aItem after it was moved or resized, and mark
+     * the connectivity of the screen dirty.
+     *
+     * Items owned by another item (sheet pins, component fields and pins) update their
+     * parent.  Items which are not in this screen are ignored.
+     */
+    void Update( SCH_ITEM* aItem );
+
     /**
      * Delete all draw items and clears the project settings.
      */
@@ -199,6 +264,8 @@ public:
      * @param aAccuracy The maximum distance within \a Position to check for an item.
      * @param aType The type of item to find.
      * @return The item found that meets the search criteria or NULL if none found.
+     *         Items are searched through the spatial index, so when several items match
+     *         the one returned is not necessarily the first one of the item list.
      */
     SCH_ITEM* GetItem( const wxPoint& aPosition, int aAccuracy = 0,
                        KICAD_T aType = SCH_LOCATE_ANY_T ) const;
@@ -262,9 +329,15 @@ public:
 
     /**
      * Test all of the connectable objects in the schematic for unused connection points.
+     *
+     * The end points are indexed by position, so each item is only tested against the end
+     * points coincident with its own connection points and the wires or buses passing
+     * through them.
+     *
+     * @param aChangedHandler is called for each item whose connection state changed.
      * @return True if any connection state changes were made.
      */
-    bool TestDanglingEnds();
+    bool TestDanglingEnds( std::function<void( SCH_ITEM* )> aChangedHandler = nullptr );
 
     /**
      * Replace all of the wires, buses, and junctions in the screen with \a aWireList.
@@ -44,6 +44,7 @@ static const wxString global_tbl_name( "sym-lib-table" );
 
 const char* SYMBOL_LIB_TABLE::PropPowerSymsOnly = "pwr_sym_only";
 const char* SYMBOL_LIB_TABLE::PropNonPowerSymsOnly = "non_pwr_sym_only";
+const char* SYMBOL_LIB_TABLE::PropNoDrawItems = "no_draw_items";
 int SYMBOL_LIB_TABLE::m_modifyHash = 1;     // starts at 1 and goes up
 
 
@@ -305,7 +306,8 @@ SYMBOL_LIB_TABLE_ROW* SYMBOL_LIB_TABLE::FindRow( const wxString& aNickname )
 
 
 void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_PART*>& aSymbolList,
-                                      const wxString& aNickname, bool aPowerSymbolsOnly )
+                                      const wxString& aNickname, bool aPowerSymbolsOnly,
+                                      bool aNoDrawItems )
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */  );
@@ -315,9 +317,12 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_PART*>& aSymbolList,
     if( aPowerSymbolsOnly )
         row->SetOptions( row->GetOptions() + " " + PropPowerSymsOnly );
 
+    if( aNoDrawItems )
+        row->SetOptions( row->GetOptions() + "|" + PropNoDrawItems );
+
     row->plugin->EnumerateSymbolLib( aSymbolList, row->GetFullURI( true ), row->GetProperties() );
 
-    if( aPowerSymbolsOnly )
+    if( aPowerSymbolsOnly || aNoDrawItems )
         row->SetOptions( options );
 
     // The library cannot know its own name, because it might have been renamed or moved.
@@ -112,6 +112,7 @@ public:
 
     static const char* PropPowerSymsOnly;
     static const char* PropNonPowerSymsOnly;
+    static const char* PropNoDrawItems;
 
     virtual void Parse( LIB_TABLE_LEXER* aLexer ) override;
 
@@ -158,8 +159,19 @@ public:
     void EnumerateSymbolLib( const wxString& aNickname, wxArrayString& aAliasNames,
                              bool aPowerSymbolsOnly = false );
 
+    /**
+     * Load all of the symbols contained within the library given by @a aNickname.
+     *
+     * @param aAliasList is a reference to an array for the symbols.
+     * @param aNickname is a locator for the "library", it is a "name" in LIB_TABLE_ROW.
+     * @param aPowerSymbolsOnly is a flag to load only power symbols.
+     * @param aNoDrawItems allows plugins to skip the pins and graphics of the symbols for
+     *                     callers which only need the names, fields and documentation.
+     *
+     * @throw IO_ERROR if the library cannot be found or loaded.
+     */
     void LoadSymbolLib( std::vector<LIB_PART*>& aAliasList, const wxString& aNickname,
-                        bool aPowerSymbolsOnly = false );
+                        bool aPowerSymbolsOnly = false, bool aNoDrawItems = false );
 
     /**
      * Load a #LIB_PART having @a aName from the library given by @a aNickname.
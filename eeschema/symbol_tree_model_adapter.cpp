@@ -19,10 +19,16 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <thread>
+
 #include <wx/tokenzr.h>
 #include <wx/progdlg.h>
 
 #include <eda_pattern_match.h>
+#include <common.h>
+#include <macros.h>
+#include <sync_queue.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
 #include <generate_alias_info.h>
@@ -62,20 +68,64 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
                                     aNicknames.size(), aParent );
     }
 
-    unsigned int ii = 0;
+    std::vector<wxString>               descriptions;
+    std::vector<std::vector<LIB_PART*>> libSymbols( aNicknames.size() );
+    std::vector<wxString>               libErrors( aNicknames.size() );
+    SYNC_QUEUE<size_t>                  queue_in;
+    std::atomic<size_t>                 count_finished( 0 );
+    std::atomic<size_t>                 last_finished( 0 );
+    std::vector<std::thread>            threads;
+
+    // The library table builds its nickname index on the first lookup, which is not thread
+    // safe, so the descriptions are fetched before the workers start.
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+    {
+        descriptions.push_back( m_libs->GetDescription( aNicknames[ii] ) );
+        queue_in.push( ii );
+    }
+
+    // Parse the libraries in parallel, one library per worker at a time.  WARNING! This
+    // requires changing the locale, which is GLOBAL.  See FOOTPRINT_LIST_IMPL::JoinWorkers().
+    LOCALE_IO toggle_locale;
 
-    for( const auto& nickname : aNicknames )
+    size_t num_threads = std::min<size_t>( aNicknames.size(),
+                                           std::thread::hardware_concurrency() + 1 );
+
+    for( size_t ii = 0; ii < num_threads; ++ii )
+    {
+        threads.emplace_back( [&]() {
+            size_t libIndex;
+
+            while( queue_in.pop( libIndex ) )
+            {
+                loadLibrary( aNicknames[libIndex], libSymbols[libIndex], libErrors[libIndex] );
+
+                last_finished.store( libIndex );
+                count_finished.fetch_add( 1 );
+            }
+        } );
+    }
+
+    while( count_finished.load() < aNicknames.size() )
     {
         if( prg && wxGetUTCTimeMillis() > nextUpdate )
         {
-            prg->Update( ii, wxString::Format( _( "Loading library \"%s\"" ), nickname ) );
+            prg->Update( count_finished.load(),
+                         wxString::Format( _( "Loading library \"%s\"" ),
+                                           aNicknames[last_finished.load()] ) );
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
 
-        AddLibrary( nickname );
-        ii++;
+        wxMilliSleep( 20 );
     }
 
+    for( auto& thr : threads )
+        thr.join();
+
+    // The tree itself is only modified from this thread, in the order of aNicknames.
+    for( size_t ii = 0; ii < aNicknames.size(); ++ii )
+        addLibrary( aNicknames[ii], descriptions[ii], libSymbols[ii], libErrors[ii] );
+
     m_tree.AssignIntrinsicRanks();
 
     if( prg )
@@ -88,26 +138,61 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
 
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
-    bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
-    std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
+    std::vector<LIB_PART*> symbols;
+    wxString               error;
+
+    loadLibrary( aLibNickname, symbols, error );
+    addLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), symbols, error );
+}
+
+
+bool SYMBOL_TREE_MODEL_ADAPTER::loadLibrary( const wxString& aLibNickname,
+                                             std::vector<LIB_PART*>& aSymbols,
+                                             wxString& aError ) const
+{
+    bool onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
 
     try
     {
-        m_libs->LoadSymbolLib( symbols, aLibNickname, onlyPowerSymbols );
+        // The tree only shows names and descriptions, symbols are loaded in full on demand.
+        m_libs->LoadSymbolLib( aSymbols, aLibNickname, onlyPowerSymbols, true );
     }
     catch( const IO_ERROR& ioe )
+    {
+        aError = ioe.What();
+        return false;
+    }
+    catch( const std::exception& e )
+    {
+        // Nothing may escape a worker thread, it would terminate the application.
+        aError = FROM_UTF8( e.what() );
+
+        if( aError.IsEmpty() )
+            aError = _( "Unexpected error" );
+
+        return false;
+    }
+
+    return true;
+}
+
+
+void SYMBOL_TREE_MODEL_ADAPTER::addLibrary( const wxString& aLibNickname,
+                                            const wxString& aDescription,
+                                            const std::vector<LIB_PART*>& aSymbols,
+                                            const wxString& aError )
+{
+    if( !aError.IsEmpty() )
     {
         wxLogError( wxString::Format( _( "Error loading symbol library %s.\n\n%s" ),
                                       aLibNickname,
-                                      ioe.What() ) );
-        return;
+                                      aError ) );
     }
-
-    if( symbols.size() > 0 )
+    else if( aSymbols.size() > 0 )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
-        DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
+        std::vector<LIB_TREE_ITEM*> comp_list( aSymbols.begin(), aSymbols.end() );
+
+        DoAddLibrary( aLibNickname, aDescription, comp_list, false );
     }
 }
 
@@ -25,6 +25,7 @@
 #include <lib_tree_model_adapter.h>
 
 class LIB_TABLE;
+class LIB_PART;
 class SYMBOL_LIB_TABLE;
 
 class SYMBOL_TREE_MODEL_ADAPTER : public LIB_TREE_MODEL_ADAPTER
@@ -44,6 +45,7 @@ public:
 
     /**
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
+     * The libraries are loaded in parallel by worker threads.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
      * @param aNicknames is the list of library nicknames
@@ -62,6 +64,23 @@ protected:
     SYMBOL_TREE_MODEL_ADAPTER( LIB_TABLE* aLibs );
 
 private:
+    /**
+     * Read the symbols of a library, without the tree.  Safe to call from worker threads.
+     *
+     * @param aLibNickname is the library to read.
+     * @param aSymbols receives the symbols of the library.
+     * @param aError receives the error message when the library cannot be read.
+     * @return true if the library was read.
+     */
+    bool loadLibrary( const wxString& aLibNickname, std::vector<LIB_PART*>& aSymbols,
+                      wxString& aError ) const;
+
+    /**
+     * Add the symbols read by loadLibrary() to the tree, or report the error.
+     */
+    void addLibrary( const wxString& aLibNickname, const wxString& aDescription,
+                     const std::vector<LIB_PART*>& aSymbols, const wxString& aError );
+
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
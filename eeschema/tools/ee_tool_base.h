@@ -109,6 +109,9 @@ protected:
             getView()->Update( aItem->GetParent() );
 
         getView()->Update( aItem );
+
+        if( !m_isLibEdit )
+            m_frame->GetScreen()->Update( static_cast<SCH_ITEM*>( aItem ) );
     }
 
 
@@ -83,6 +83,11 @@ public:
      */
     int m_coroutineStackSize;
 
+    /**
+     * Report the time taken by each ERC step in the ERC dialog messages
+     */
+    bool m_showErcTimings;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -167,4 +169,10 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/**
+ * The text attributes, plotter and callback of basic_gal are shared by all its users: code
+ * drawing or measuring texts with it must hold this lock, as plots can run on several threads.
+ */
+extern std::recursive_mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
@@ -0,0 +1,373 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __PACKED_RTREE_H
+#define __PACKED_RTREE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <math/box2.h>
+
+
+/**
+ * Class PACKED_RTREE
+ *
+ * A static R-tree, bulk loaded from a set of (bounding box, item) entries. The entries are
+ * sorted along a Hilbert curve and every level of the tree groups FANOUT consecutive nodes
+ * of the level below, so the whole tree is stored in a few contiguous arrays and has no
+ * per-node allocations.
+ *
+ * Entries are added with Add() and the tree is built with Build(). Entries can be removed
+ * afterwards (they are only marked as removed and skipped by searches), but new entries
+ * require a rebuild. Searches before Build() scan the entries linearly.
+ */
+template <class T, int FANOUT = 16>
+class PACKED_RTREE
+{
+public:
+    PACKED_RTREE() :
+        m_built( false ),
+        m_removedCount( 0 )
+    {}
+
+    /**
+     * Function Add()
+     *
+     * Adds an entry. Invalidates the tree until the next Build().
+     * @return the entry number, valid until the next Build().
+     */
+    size_t Add( const BOX2I& aBox, T aItem )
+    {
+        m_entries.push_back( ENTRY( aBox, aItem ) );
+        m_built = false;
+
+        return m_entries.size() - 1;
+    }
+
+    /**
+     * Function Remove()
+     *
+     * Marks the entry aEntry as removed.
+     */
+    void Remove( size_t aEntry )
+    {
+        if( !m_entries[aEntry].m_removed )
+        {
+            m_entries[aEntry].m_removed = true;
+            m_removedCount++;
+        }
+    }
+
+    /**
+     * Function Build()
+     *
+     * Drops the removed entries and packs the remaining ones. Entry numbers change: use
+     * Item() to map them to the items.
+     */
+    void Build();
+
+    void Clear()
+    {
+        m_entries.clear();
+        m_nodes.clear();
+        m_levelStart.clear();
+        m_built = false;
+        m_removedCount = 0;
+    }
+
+    size_t Size() const { return m_entries.size(); }
+
+    size_t RemovedCount() const { return m_removedCount; }
+
+    T Item( size_t aEntry ) const { return m_entries[aEntry].m_item; }
+
+    bool IsRemoved( size_t aEntry ) const { return m_entries[aEntry].m_removed; }
+
+    /**
+     * Function Search()
+     *
+     * Calls aVisitor( item ) for every entry whose bounding box overlaps aBox. The visitor
+     * returns false to stop the search.
+     * @return the number of entries found.
+     */
+    template <class V>
+    int Search( const BOX2I& aBox, V& aVisitor ) const
+    {
+        RECT rect( aBox );
+        int  count = 0;
+
+        if( !m_built )
+        {
+            for( const ENTRY& entry : m_entries )
+            {
+                if( !entry.m_removed && entry.m_rect.Overlaps( rect ) )
+                {
+                    count++;
+
+                    if( !aVisitor( entry.m_item ) )
+                        break;
+                }
+            }
+        }
+        else if( !m_levelStart.empty() )
+        {
+            searchNode( (int) m_levelStart.size() - 1, 0, rect, aVisitor, count );
+        }
+
+        return count;
+    }
+
+private:
+    struct RECT
+    {
+        RECT() :
+            m_minX( 0 ), m_minY( 0 ), m_maxX( 0 ), m_maxY( 0 )
+        {}
+
+        RECT( const BOX2I& aBox ) :
+            m_minX( aBox.GetX() ),
+            m_minY( aBox.GetY() ),
+            m_maxX( aBox.GetRight() ),
+            m_maxY( aBox.GetBottom() )
+        {}
+
+        bool Overlaps( const RECT& aOther ) const
+        {
+            return m_minX <= aOther.m_maxX && aOther.m_minX <= m_maxX
+                   && m_minY <= aOther.m_maxY && aOther.m_minY <= m_maxY;
+        }
+
+        void Merge( const RECT& aOther )
+        {
+            m_minX = std::min( m_minX, aOther.m_minX );
+            m_minY = std::min( m_minY, aOther.m_minY );
+            m_maxX = std::max( m_maxX, aOther.m_maxX );
+            m_maxY = std::max( m_maxY, aOther.m_maxY );
+        }
+
+        int m_minX, m_minY, m_maxX, m_maxY;
+    };
+
+    struct ENTRY
+    {
+        ENTRY( const BOX2I& aBox, T aItem ) :
+            m_rect( aBox ),
+            m_item( aItem ),
+            m_removed( false )
+        {}
+
+        RECT m_rect;
+        T    m_item;
+        bool m_removed;
+    };
+
+    static uint32_t hilbertIndex( uint32_t aX, uint32_t aY );
+
+    /**
+     * Visits the children of the node aNode of level aLevel. Level 0 are the entries
+     * themselves, nodes of level n + 1 bound FANOUT consecutive nodes of level n.
+     */
+    template <class V>
+    bool searchNode( int aLevel, size_t aNode, const RECT& aRect, V& aVisitor,
+                     int& aCount ) const
+    {
+        size_t first = aNode * FANOUT;
+        size_t last = std::min( first + FANOUT, levelSize( aLevel - 1 ) );
+
+        if( aLevel == 1 )
+        {
+            for( size_t i = first; i < last; i++ )
+            {
+                const ENTRY& entry = m_entries[i];
+
+                if( !entry.m_removed && entry.m_rect.Overlaps( aRect ) )
+                {
+                    aCount++;
+
+                    if( !aVisitor( entry.m_item ) )
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        const RECT* children = &m_nodes[m_levelStart[aLevel - 1]];
+
+        for( size_t i = first; i < last; i++ )
+        {
+            if( children[i].Overlaps( aRect )
+                    && !searchNode( aLevel - 1, i, aRect, aVisitor, aCount ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t levelSize( int aLevel ) const
+    {
+        if( aLevel == 0 )
+            return m_entries.size();
+
+        size_t end = aLevel + 1 < (int) m_levelStart.size() ? m_levelStart[aLevel + 1]
+                                                            : m_nodes.size();
+
+        return end - m_levelStart[aLevel];
+    }
+
+    std::vector<ENTRY>  m_entries;
+
+    ///> node boxes of the levels 1 and up, stored level after level
+    std::vector<RECT>   m_nodes;
+
+    ///> offset of each level in m_nodes (the entry for level 0 is unused)
+    std::vector<size_t> m_levelStart;
+
+    bool   m_built;
+    size_t m_removedCount;
+};
+
+
+template <class T, int FANOUT>
+uint32_t PACKED_RTREE<T, FANOUT>::hilbertIndex( uint32_t aX, uint32_t aY )
+{
+    // Position along a Hilbert curve covering a 65536 x 65536 grid
+    uint32_t d = 0;
+
+    for( uint32_t s = 1 << 15; s > 0; s >>= 1 )
+    {
+        uint32_t rx = ( aX & s ) > 0;
+        uint32_t ry = ( aY & s ) > 0;
+
+        d += s * s * ( ( 3 * rx ) ^ ry );
+
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                aX = s - 1 - aX;
+                aY = s - 1 - aY;
+            }
+
+            std::swap( aX, aY );
+        }
+    }
+
+    return d;
+}
+
+
+template <class T, int FANOUT>
+void PACKED_RTREE<T, FANOUT>::Build()
+{
+    if( m_removedCount )
+    {
+        m_entries.erase( std::remove_if( m_entries.begin(), m_entries.end(),
+                                 []( const ENTRY& aEntry ) { return aEntry.m_removed; } ),
+                m_entries.end() );
+        m_removedCount = 0;
+    }
+
+    m_nodes.clear();
+    m_levelStart.clear();
+    m_built = true;
+
+    if( m_entries.empty() )
+        return;
+
+    // Sort the entries along a Hilbert curve running through their centers
+    RECT extents = m_entries[0].m_rect;
+
+    for( const ENTRY& entry : m_entries )
+        extents.Merge( entry.m_rect );
+
+    double spanX = std::max( 1.0, (double) extents.m_maxX - extents.m_minX );
+    double spanY = std::max( 1.0, (double) extents.m_maxY - extents.m_minY );
+
+    std::vector<uint32_t> keys( m_entries.size() );
+
+    for( size_t i = 0; i < m_entries.size(); i++ )
+    {
+        const RECT& r = m_entries[i].m_rect;
+        double      cx = ( (double) r.m_minX + r.m_maxX ) / 2.0 - extents.m_minX;
+        double      cy = ( (double) r.m_minY + r.m_maxY ) / 2.0 - extents.m_minY;
+
+        keys[i] = hilbertIndex( (uint32_t)( cx / spanX * 65535.0 ),
+                                (uint32_t)( cy / spanY * 65535.0 ) );
+    }
+
+    std::vector<size_t> order( m_entries.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(),
+               [&keys]( size_t a, size_t b ) { return keys[a] < keys[b]; } );
+
+    std::vector<ENTRY> sorted;
+    sorted.reserve( m_entries.size() );
+
+    for( size_t i : order )
+        sorted.push_back( m_entries[i] );
+
+    m_entries.swap( sorted );
+
+    // Build the levels bottom-up, until a single root node remains
+    m_levelStart.push_back( 0 );
+
+    size_t childCount = m_entries.size();
+    int    level = 1;
+
+    do
+    {
+        size_t start = m_nodes.size();
+        size_t count = ( childCount + FANOUT - 1 ) / FANOUT;
+
+        m_levelStart.push_back( start );
+
+        for( size_t n = 0; n < count; n++ )
+        {
+            size_t first = n * FANOUT;
+            size_t last = std::min( first + FANOUT, childCount );
+            RECT   box;
+
+            for( size_t i = first; i < last; i++ )
+            {
+                const RECT& child = ( level == 1 ) ? m_entries[i].m_rect
+                                                   : m_nodes[m_levelStart[level - 1] + i];
+
+                if( i == first )
+                    box = child;
+                else
+                    box.Merge( child );
+            }
+
+            m_nodes.push_back( box );
+        }
+
+        childCount = count;
+        level++;
+    } while( childCount > 1 );
+}
+
+#endif // __PACKED_RTREE_H
@@ -0,0 +1,90 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SEG_BATCH_H
+#define __SEG_BATCH_H
+
+#include <cstdint>
+
+#include <geometry/seg.h>
+
+class SHAPE_LINE_CHAIN;
+
+/**
+ * Class SEG_BATCH
+ *
+ * Up to SEG_BATCH::SIZE consecutive segments of a line chain, with their bounding boxes
+ * stored in structure of arrays layout, to test a segment against all of them at once. The bounding
+ * box filter of SHAPE_LINE_CHAIN::Collide() is evaluated 4 segments at a time with SSE2 when
+ * the compiler provides it (with scalar code otherwise), and only the segments passing it are
+ * tested with SEG::Collide(): the results are exactly those of testing the segments one by one.
+ */
+class SEG_BATCH
+{
+public:
+    static const int SIZE = 64;
+
+    SEG_BATCH() :
+        m_chain( nullptr ),
+        m_first( 0 ),
+        m_count( 0 )
+    {}
+
+    /**
+     * Function Load()
+     *
+     * Loads the segments of aChain from index aFirst on, up to SIZE of them.
+     * @return the number of segments loaded.
+     */
+    int Load( const SHAPE_LINE_CHAIN& aChain, int aFirst );
+
+    /**
+     * Function Collide()
+     *
+     * Checks if segment aSeg collides with a segment of the batch, as
+     * SHAPE_LINE_CHAIN::Collide() does.
+     * @param aClearance minimum distance that does not qualify as a collision, must be positive.
+     * @return true, when a collision has been found
+     */
+    bool Collide( const SEG& aSeg, int aClearance ) const;
+
+private:
+    ///> Returns the mask of the segments that may pass the bounding box filter for aSeg
+    uint64_t candidates( const SEG& aSeg, int aClearance ) const;
+
+    const SHAPE_LINE_CHAIN* m_chain;
+    int                     m_first;
+    int                     m_count;
+
+    ///> bounding box of the whole batch
+    VECTOR2I                m_min;
+    VECTOR2I                m_max;
+
+    ///> bounding boxes of the segments
+    alignas( 16 ) int32_t   m_minX[SIZE];
+    alignas( 16 ) int32_t   m_minY[SIZE];
+    alignas( 16 ) int32_t   m_maxX[SIZE];
+    alignas( 16 ) int32_t   m_maxY[SIZE];
+};
+
+#endif    // __SEG_BATCH_H
@@ -297,6 +297,16 @@ public:
      */
     bool Collide( const SEG& aSeg, int aClearance = 0 ) const override;
 
+    /**
+     * Function Collide()
+     *
+     * Checks if a segment of line chain aChain lies closer to us than aClearance.
+     * @param aChain the line chain to check for collisions with
+     * @param aClearance minimum distance that does not qualify as a collision.
+     * @return true, when a collision has been found
+     */
+    bool Collide( const SHAPE_LINE_CHAIN& aChain, int aClearance = 0 ) const;
+
     /**
      * Function Distance()
      *
@@ -45,7 +45,12 @@
 #include "ar_autoplacer.h"
 #include "ar_cell.h"
 #include "ar_matrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <thread>
 
 #define AR_GAIN            16
 #define AR_KEEPOUT_MARGIN  500
@@ -433,7 +438,7 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( MODULE* Module )
  *
  * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
  */
-int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
+int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side ) const
 {
     EDA_RECT rect = aRect;
 
@@ -468,21 +473,15 @@ int AR_AUTOPLACER::testRectangle( const EDA_RECT& aRect, int side )
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
+    int data = m_matrix.FindBlockedCell( row_min, row_max, col_min, col_max, side );
 
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
+    if( data < 0 )
+        return AR_FREE_CELL;
 
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
-    }
+    if( ( data & CELL_IS_ZONE ) == 0 )
+        return AR_OUT_OF_BOARD;
 
-    return AR_FREE_CELL;
+    return AR_OCCUIPED_BY_MODULE;
 }
 
 int AR_AUTOPLACER::testModuleByPolygon( MODULE* aModule, int aSide, const wxPoint& aOffset )
@@ -506,7 +505,7 @@ int AR_AUTOPLACER::testModuleByPolygon( MODULE* aModule, int aSide, const wxPoin
  * aRect):
  * (Sum of cells in terms of distance)
  */
-unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side )
+unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int side ) const
 {
     wxPoint start   = aRect.GetOrigin();
     wxPoint end     = aRect.GetEnd();
@@ -537,29 +536,18 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
     if( col_max >= ( m_matrix.m_Ncols - 1 ) )
         col_max = m_matrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
-
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
-
-    return keepOutCost;
+    // The distance map contains the "cost" of the cells: in autoplace this is the
+    // cost of the cells inside aRect
+    return m_matrix.SumDist( row_min, row_max, col_min, col_max, side );
 }
 
 
 /* Test if the module can be placed on the board.
  * Returns the value TstRectangle().
- * Module is known by its bounding box
+ * Module is known by its bounding box aFpBBox, at the tested position
  */
-int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset )
+int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide,
+                                      const EDA_RECT& aFpBBox ) const
 {
     int side = AR_SIDE_TOP;
     int otherside = AR_SIDE_BOTTOM;
@@ -569,10 +557,7 @@ int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const
         side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
     }
 
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
-    fpBBox.Move( -aOffset );
-
-    buildFpAreas( aModule, 0 );
+    EDA_RECT    fpBBox = aFpBBox;
 
     int diag = //testModuleByPolygon( aModule, side, aOffset );
         testRectangle( fpBBox, side );
@@ -600,7 +585,7 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 {
     int     error = 1;
     wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    TstOtherSide;
 
     aModule->CalculateBoundingBox();
@@ -624,9 +609,6 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    auto moduleOffset = mod_pos - m_curPosition;
-
     /* Examine pads, and set TstOtherSide to true if a footprint
      * has at least 1 pad through.
      */
@@ -646,42 +628,102 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
+    buildFpAreas( aModule, 0 );
+    collectRatsnestTargets( aModule );
 
     min_cost = -1.0;
 //    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
 
+    int grid = m_matrix.m_GridRouting;
+    int colCount = 0;
+    int rowCount = 0;
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    for( int x = initialPos.x; x < xylimit.x; x += grid )
+        colCount++;
+
+    for( int y = initialPos.y; y < xylimit.y; y += grid )
+        rowCount++;
+
+    // The positions are evaluated by tiles of one column of the grid, each tile
+    // keeping its best position in the scan order of a single thread.
+    struct TILE_RESULT
     {
-        m_curPosition.y = initialPos.y;
+        double  m_cost = -1.0;
+        wxPoint m_pos;
+    };
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    std::vector<TILE_RESULT> tiles( colCount );
+    std::atomic<size_t>      nextItem( 0 );
+    size_t                   parallelThreadCount =
+            std::min<size_t>( std::thread::hardware_concurrency(), tiles.size() );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto tile_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+        double localMin = -1.0;     // best score found by this thread
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            moduleOffset = mod_pos - m_curPosition;
-            int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, moduleOffset );
+        for( size_t i = nextItem++; i < tiles.size(); i = nextItem++ )
+        {
+            TILE_RESULT& tile = tiles[i];
+            wxPoint      pos( initialPos.x + (int) i * grid, initialPos.y );
+            EDA_RECT     bbox = fpBBox;
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
+            for( int j = 0; j < rowCount; j++, pos.y += grid )
             {
-                error = 0;
-                // m_frame->build_ratsnest_module( aModule ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aModule, moduleOffset );
-                Score       = curr_cost + keepOutCost;
+                bbox.SetOrigin( fpBBoxOrg + pos );
+                int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, bbox );
+
+                if( keepOutCost < 0 )   // i.e. if the module cannot be put here
+                    continue;
+
+                // The ratsnest cost is not negative: this position cannot beat (or equal)
+                // the best one of this thread
+                if( localMin >= 0 && keepOutCost > localMin )
+                    continue;
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                double curr_cost = computePlacementRatsnestCost( aModule, mod_pos - pos );
+                double Score = curr_cost + keepOutCost;
+
+                if( ( tile.m_cost >= Score ) || ( tile.m_cost < 0 ) )
                 {
-                    LastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
+                    tile.m_pos = pos;
+                    tile.m_cost = Score;
                 }
+
+                if( ( localMin >= Score ) || ( localMin < 0 ) )
+                    localMin = Score;
             }
+
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        tile_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, tile_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    // Merge the tiles in the scan order: on equal scores, the last position wins
+    for( const TILE_RESULT& tile : tiles )
+    {
+        if( tile.m_cost < 0 )
+            continue;
+
+        error = 0;
+
+        if( (min_cost >= tile.m_cost ) || (min_cost < 0 ) )
+        {
+            LastPosOK   = tile.m_pos;
+            min_cost    = tile.m_cost;
         }
     }
 
@@ -693,39 +735,60 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 }
 
 
-const D_PAD* AR_AUTOPLACER::nearestPad( MODULE *aRefModule, D_PAD* aRefPad, const wxPoint& aOffset)
+void AR_AUTOPLACER::collectRatsnestTargets( MODULE* aModule )
 {
-    const D_PAD* nearest = nullptr;
-    int64_t nearestDist = INT64_MAX;
+    m_ratsnestTargets.clear();
 
-    for ( auto mod : m_board->Modules() )
+    for( auto pad : aModule->Pads() )
     {
-        if ( mod == aRefModule )
-            continue;
-
-        if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
-            continue;
+        std::vector<D_PAD*> targets;
 
-        for ( auto pad: mod->Pads() )
+        if( pad->GetNetCode() > 0 )
         {
-            if ( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
-                continue;
+            for( auto mod : m_board->Modules() )
+            {
+                if( mod == aModule )
+                    continue;
 
-            auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+                if( !m_matrix.m_BrdBox.Contains( mod->GetPosition() ) )
+                    continue;
 
-            if ( dist < nearestDist )
-            {
-                nearestDist = dist;
-                nearest = pad;
+                for( auto candidate : mod->Pads() )
+                {
+                    if( candidate->GetNetCode() == pad->GetNetCode() )
+                        targets.push_back( candidate );
+                }
             }
         }
+
+        m_ratsnestTargets.emplace_back( pad, std::move( targets ) );
+    }
+}
+
+
+const D_PAD* AR_AUTOPLACER::nearestPad( D_PAD* aRefPad, const std::vector<D_PAD*>& aTargets,
+                                        const wxPoint& aOffset ) const
+{
+    const D_PAD* nearest = nullptr;
+    int64_t nearestDist = INT64_MAX;
+
+    for ( auto pad : aTargets )
+    {
+        auto dist = (VECTOR2I( aRefPad->GetPosition() - aOffset ) - VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+
+        if ( dist < nearestDist )
+        {
+            nearestDist = dist;
+            nearest = pad;
+        }
     }
 
     return nearest;
 }
 
 
-double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule, const wxPoint& aOffset )
+double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule,
+                                                    const wxPoint& aOffset ) const
 {
     double  curr_cost;
     VECTOR2I start;      // start point of a ratsnest
@@ -734,9 +797,10 @@ double AR_AUTOPLACER::computePlacementRatsnestCost( MODULE *aModule, const wxPoi
 
     curr_cost = 0;
 
-    for ( auto pad : aModule->Pads() )
+    for ( const auto& padTargets : m_ratsnestTargets )
     {
-        auto nearest = nearestPad( aModule, pad, aOffset );
+        D_PAD* pad = padTargets.first;
+        auto nearest = nearestPad( pad, padTargets.second, aOffset );
 
         if( !nearest )
             continue;
@@ -982,6 +1046,9 @@ AR_RESULT AR_AUTOPLACER::AutoplaceModules( std::vector<MODULE*> aModules,
 
         double initialOrient = module->GetOrientation();
 
+        // The matrix changed with the last placed module
+        m_matrix.BuildPlacementMaps();
+
         error = getOptimalModulePlacement( module );
         double bestScore = m_minCost;
         double bestRotation = 0.0;
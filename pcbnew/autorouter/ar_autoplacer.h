@@ -103,12 +103,18 @@ private:
     bool         fillMatrix();
     void         genModuleOnRoutingMatrix( MODULE* Module );
 
-    int          testRectangle( const EDA_RECT& aRect, int side );
+    // The tests and costs of a footprint position only read the placement maps of m_matrix
+    // and m_ratsnestTargets: they are evaluated in parallel by getOptimalModulePlacement()
+    int          testRectangle( const EDA_RECT& aRect, int side ) const;
     int          testModuleByPolygon( MODULE* aModule,int aSide, const wxPoint& aOffset );
-    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
-    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset );
+    unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side ) const;
+    int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide,
+                                    const EDA_RECT& aFpBBox ) const;
     int          getOptimalModulePlacement( MODULE* aModule );
-    double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset );
+    double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset ) const;
+
+    // Fill m_ratsnestTargets for the pads of aModule
+    void         collectRatsnestTargets( MODULE* aModule );
 
     /**
      * Find the "best" module place. The criteria are:
@@ -118,7 +124,8 @@ private:
     MODULE*      pickModule();
 
     void         placeModule( MODULE* aModule, bool aDoNotRecreateRatsnest, const wxPoint& aPos );
-    const D_PAD* nearestPad( MODULE* aRefModule, D_PAD* aRefPad, const wxPoint& aOffset );
+    const D_PAD* nearestPad( D_PAD* aRefPad, const std::vector<D_PAD*>& aTargets,
+                             const wxPoint& aOffset ) const;
 
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void         addFpBody( wxPoint aStart, wxPoint aEnd, LSET aLayerMask );
@@ -137,6 +144,10 @@ private:
     SHAPE_POLY_SET m_fpAreaTop;         // The polygonal description of the footprint to place, top side;
     SHAPE_POLY_SET m_fpAreaBottom;      // The polygonal description of the footprint to place, bottom side;
 
+    // The pads of the footprint to place, each with the pads of the same net of the other
+    // footprints inside the board it can be connected to
+    std::vector<std::pair<D_PAD*, std::vector<D_PAD*>>> m_ratsnestTargets;
+
     BOARD* m_board;
 
     wxPoint m_curPosition;
@@ -28,6 +28,11 @@
 #include "ar_matrix.h"
 #include "ar_cell.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include <common.h>
 #include <math_for_graphics.h>
 #include <trigo.h>
@@ -49,6 +54,7 @@ AR_MATRIX::AR_MATRIX()
     m_RoutingLayersCount = 1;
     m_GridRouting = 0;
     m_RouteCount = 0;
+    m_bitWords = 0;
 }
 
 
@@ -165,6 +171,10 @@ void AR_MATRIX::UnInitRoutingMatrix()
             delete m_BoardSide[ii];
             m_BoardSide[ii] = nullptr;
         }
+
+        m_outsideBits[ii].clear();
+        m_moduleBits[ii].clear();
+        m_distSums[ii].clear();
     }
 
     m_Nrows = m_Ncols = 0;
@@ -294,6 +304,179 @@ void AR_MATRIX::SetDir( int aRow, int aCol, int aSide, int x )
     p[aRow * m_Ncols + aCol] = (char) x;
 }
 
+
+void AR_MATRIX::BuildPlacementMaps()
+{
+    m_bitWords = ( m_Ncols + 63 ) / 64;
+
+    int sides[AR_MAX_ROUTING_LAYERS_COUNT];
+    int sideCount = 0;
+
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        m_outsideBits[side].clear();
+        m_moduleBits[side].clear();
+        m_distSums[side].clear();
+
+        if( !m_BoardSide[side] || !m_DistSide[side] )
+            continue;
+
+        m_outsideBits[side].resize( (size_t) m_Nrows * m_bitWords, 0 );
+        m_moduleBits[side].resize( (size_t) m_Nrows * m_bitWords, 0 );
+        m_distSums[side].resize( (size_t) ( m_Nrows + 1 ) * ( m_Ncols + 1 ), 0 );
+        sides[sideCount++] = side;
+    }
+
+    // Rows are packed and summed independently
+    size_t              rowCount = (size_t) sideCount * m_Nrows;
+    std::atomic<size_t> nextItem( 0 );
+    size_t              parallelThreadCount =
+            std::min<size_t>( std::thread::hardware_concurrency(), rowCount );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto build_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < rowCount; i = nextItem++ )
+        {
+            buildPlacementRow( i % m_Nrows, sides[i / m_Nrows] );
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        build_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, build_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    // Turn the row sums into area sums
+    for( int ii = 0; ii < sideCount; ii++ )
+    {
+        uint32_t* sums = m_distSums[sides[ii]].data();
+        int       stride = m_Ncols + 1;
+
+        for( int row = 1; row < m_Nrows; row++ )
+        {
+            uint32_t* prev = sums + row * stride;
+            uint32_t* curr = prev + stride;
+
+            for( int col = 1; col <= m_Ncols; col++ )
+                curr[col] += prev[col];
+        }
+    }
+}
+
+
+void AR_MATRIX::buildPlacementRow( int aRow, int aSide )
+{
+    const MATRIX_CELL* cells = m_BoardSide[aSide] + aRow * m_Ncols;
+    const DIST_CELL*   dist = m_DistSide[aSide] + aRow * m_Ncols;
+    uint64_t*          outside = m_outsideBits[aSide].data() + (size_t) aRow * m_bitWords;
+    uint64_t*          module = m_moduleBits[aSide].data() + (size_t) aRow * m_bitWords;
+    uint32_t*          sums = m_distSums[aSide].data() + (size_t) ( aRow + 1 ) * ( m_Ncols + 1 );
+    uint32_t           rowSum = 0;
+
+    for( int col = 0; col < m_Ncols; col++ )
+    {
+        uint64_t bit = uint64_t( 1 ) << ( col & 63 );
+
+        if( !( cells[col] & CELL_IS_ZONE ) )
+            outside[col >> 6] |= bit;
+
+        if( cells[col] & CELL_IS_MODULE )
+            module[col >> 6] |= bit;
+
+        rowSum += (uint32_t) dist[col];
+        sums[col + 1] = rowSum;
+    }
+}
+
+
+// index of the lowest bit set in aWord (not null)
+static int lowestBit( uint64_t aWord )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctzll( aWord );
+#else
+    int bit = 0;
+
+    while( !( aWord & 1 ) )
+    {
+        aWord >>= 1;
+        bit++;
+    }
+
+    return bit;
+#endif
+}
+
+
+int AR_MATRIX::FindBlockedCell( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                                int aSide ) const
+{
+    if( aRowMin > aRowMax || aColMin > aColMax )
+        return -1;
+
+    const uint64_t* outside = m_outsideBits[aSide].data();
+    const uint64_t* module = m_moduleBits[aSide].data();
+
+    int      firstWord = aColMin >> 6;
+    int      lastWord = aColMax >> 6;
+    uint64_t firstMask = ~uint64_t( 0 ) << ( aColMin & 63 );
+    uint64_t lastMask = ~uint64_t( 0 ) >> ( 63 - ( aColMax & 63 ) );
+
+    for( int row = aRowMin; row <= aRowMax; row++ )
+    {
+        size_t rowStart = (size_t) row * m_bitWords;
+
+        for( int word = firstWord; word <= lastWord; word++ )
+        {
+            uint64_t blocked = outside[rowStart + word] | module[rowStart + word];
+
+            if( word == firstWord )
+                blocked &= firstMask;
+
+            if( word == lastWord )
+                blocked &= lastMask;
+
+            if( blocked )
+            {
+                int col = word * 64 + lowestBit( blocked );
+
+                return m_BoardSide[aSide][row * m_Ncols + col];
+            }
+        }
+    }
+
+    return -1;
+}
+
+
+unsigned int AR_MATRIX::SumDist( int aRowMin, int aRowMax, int aColMin, int aColMax,
+                                 int aSide ) const
+{
+    if( aRowMin > aRowMax || aColMin > aColMax )
+        return 0;
+
+    const uint32_t* sums = m_distSums[aSide].data();
+    size_t          stride = m_Ncols + 1;
+    size_t          top = aRowMin * stride;
+    size_t          bottom = ( aRowMax + 1 ) * stride;
+
+    // Unsigned wrap around gives the exact sum modulo 2^32
+    return sums[bottom + aColMax + 1] - sums[top + aColMax + 1] - sums[bottom + aColMin]
+           + sums[top + aColMin];
+}
+
 /* The tables of distances and keep out areas are established on the basis of a
  * 50 units grid size (the pitch between the cells is 50 units).
  * The actual distance could be computed by a scaling factor, but this is
@@ -29,6 +29,9 @@
 #ifndef __AR_MATRIX_H
 #define __AR_MATRIX_H
 
+#include <cstdint>
+#include <vector>
+
 #include <eda_rect.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -136,6 +139,32 @@ public:
     int         GetDir( int aRow, int aCol, int aSide );
     void        SetDir( int aRow, int aCol, int aSide, int aDir );
 
+    /**
+     * Function BuildPlacementMaps
+     * builds the autoplacer views of the matrix: the cells outside the board (without
+     * CELL_IS_ZONE) and the cells occupied by a module (CELL_IS_MODULE) packed in bit planes
+     * of one bit per cell, and the summed-area tables of the distance (keep out cost) maps.
+     * They are not updated by the cell operations, and must be built again after the
+     * matrix is modified.
+     */
+    void BuildPlacementMaps();
+
+    /**
+     * Function FindBlockedCell
+     * scans the cells of rows aRowMin to aRowMax and columns aColMin to aColMax (bounds
+     * included, and inside the matrix) in row order, for a cell outside the board or
+     * occupied by a module. Uses the placement maps.
+     * @return the value of the first such cell, or -1 if there is none.
+     */
+    int FindBlockedCell( int aRowMin, int aRowMax, int aColMin, int aColMax, int aSide ) const;
+
+    /**
+     * Function SumDist
+     * @return the sum of the distance cells of rows aRowMin to aRowMax and columns aColMin
+     * to aColMax (bounds included, and inside the matrix), using the placement maps.
+     */
+    unsigned int SumDist( int aRowMin, int aRowMax, int aColMin, int aColMax, int aSide ) const;
+
     // calculate distance (with penalty) of a trace through a cell
     int CalcDist( int x, int y, int z, int side );
 
@@ -166,6 +195,17 @@ private:
             int color, AR_MATRIX::CELL_OP op_logic );
     void tracePcbLine( int x0, int y0, int x1, int y1, LAYER_NUM layer, int color,
             AR_MATRIX::CELL_OP op_logic );
+
+    void buildPlacementRow( int aRow, int aSide );
+
+    // Placement maps, see BuildPlacementMaps():
+    int                   m_bitWords;                                 // words per bit plane row
+    std::vector<uint64_t> m_outsideBits[AR_MAX_ROUTING_LAYERS_COUNT]; // cells without CELL_IS_ZONE
+    std::vector<uint64_t> m_moduleBits[AR_MAX_ROUTING_LAYERS_COUNT];  // cells with CELL_IS_MODULE
+
+    // m_distSums[side][( row + 1 ) * ( m_Ncols + 1 ) + col + 1] is the sum of the distance
+    // cells of rows 0 to row and columns 0 to col (modulo 2^32, as the keep out costs)
+    std::vector<uint32_t> m_distSums[AR_MAX_ROUTING_LAYERS_COUNT];
 };
 
 #endif
@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include "rect_packer.h"
+
+
+RECT_PACKER::RECT_PACKER( int aWidth ) :
+    m_width( std::max( aWidth, 1 ) ),
+    m_usedWidth( 0 ),
+    m_height( 0 )
+{
+    m_skyline.push_back( { 0, 0, m_width } );
+}
+
+
+int RECT_PACKER::levelAt( size_t aIndex, int aWidth, int aLimit ) const
+{
+    int level = 0;
+
+    for( size_t ii = aIndex; aWidth > 0; ii++ )
+    {
+        level = std::max( level, m_skyline[ii].m_y );
+
+        if( level >= aLimit )
+            return aLimit;
+
+        aWidth -= m_skyline[ii].m_width;
+    }
+
+    return level;
+}
+
+
+wxPoint RECT_PACKER::Insert( const wxSize& aSize )
+{
+    int w = std::max( aSize.x, 1 );
+    int h = std::max( aSize.y, 0 );
+
+    if( w > m_width )
+    {
+        m_skyline.push_back( { m_width, 0, w - m_width } );
+        m_width = w;
+    }
+
+    size_t best = 0;
+    int    bestY = INT_MAX;
+
+    for( size_t ii = 0; ii < m_skyline.size(); ii++ )
+    {
+        if( m_skyline[ii].m_x + w > m_width )
+            break;
+
+        int y = levelAt( ii, w, bestY );
+
+        if( y < bestY )
+        {
+            best = ii;
+            bestY = y;
+        }
+    }
+
+    int x = m_skyline[best].m_x;
+    int right = x + w;
+
+    // Replace the part of the skyline covered by the new rectangle by its top side
+    size_t last = best;
+
+    while( last < m_skyline.size() && m_skyline[last].m_x + m_skyline[last].m_width <= right )
+        last++;
+
+    if( last < m_skyline.size() && m_skyline[last].m_x < right )
+    {
+        m_skyline[last].m_width -= right - m_skyline[last].m_x;
+        m_skyline[last].m_x = right;
+    }
+
+    m_skyline.erase( m_skyline.begin() + best, m_skyline.begin() + last );
+    m_skyline.insert( m_skyline.begin() + best, { x, bestY + h, w } );
+
+    // Merge the segments at the same level
+    if( best + 1 < m_skyline.size() && m_skyline[best + 1].m_y == m_skyline[best].m_y )
+    {
+        m_skyline[best].m_width += m_skyline[best + 1].m_width;
+        m_skyline.erase( m_skyline.begin() + best + 1 );
+    }
+
+    if( best > 0 && m_skyline[best - 1].m_y == m_skyline[best].m_y )
+    {
+        m_skyline[best - 1].m_width += m_skyline[best].m_width;
+        m_skyline.erase( m_skyline.begin() + best );
+    }
+
+    m_usedWidth = std::max( m_usedWidth, right );
+    m_height = std::max( m_height, bestY + h );
+
+    return wxPoint( x, bestY );
+}
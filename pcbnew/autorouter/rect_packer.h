@@ -0,0 +1,80 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __RECT_PACKER_H
+#define __RECT_PACKER_H
+
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+/**
+ * Class RECT_PACKER
+ *
+ * Packs rectangles without overlap in an area of a given width, extending downwards as
+ * needed, with the skyline bottom-left heuristic: every rectangle goes to the lowest
+ * position (then the leftmost) it fits in above the rectangles already placed.
+ *
+ * The top contour of the placed rectangles (the skyline) is kept as a list of horizontal
+ * segments, so the cost of an insertion only depends on the number of segments, not on
+ * the number of rectangles. The holes below the skyline are not reused: inserting the
+ * rectangles by decreasing height keeps them small.
+ */
+class RECT_PACKER
+{
+public:
+    RECT_PACKER( int aWidth );
+
+    /**
+     * Function Insert
+     * places a rectangle of size aSize. The area is widened if the rectangle is wider.
+     * @return the position of the upper left corner of the rectangle.
+     */
+    wxPoint Insert( const wxSize& aSize );
+
+    ///> Returns the size of the area covered by the rectangles placed so far
+    wxSize GetSize() const
+    {
+        return wxSize( m_usedWidth, m_height );
+    }
+
+private:
+    ///> A horizontal segment of the skyline
+    struct SEGMENT
+    {
+        int m_x;
+        int m_y;
+        int m_width;
+    };
+
+    ///> Returns the lowest level a rectangle of width aWidth starting at segment aIndex
+    ///> can be placed at, or aLimit if it is not lower than aLimit.
+    int levelAt( size_t aIndex, int aWidth, int aLimit ) const;
+
+    std::vector<SEGMENT> m_skyline;     // sorted by x, covering the area width
+    int                  m_width;
+    int                  m_usedWidth;
+    int                  m_height;
+};
+
+#endif    // __RECT_PACKER_H
@@ -35,6 +35,9 @@
  */
 
 #include <algorithm>
+#include <climits>
+#include <cmath>
+#include <numeric>
 #include <fctsys.h>
 #include <convert_to_biu.h>
 #include <confirm.h>
@@ -42,130 +45,69 @@
 #include <pcb_edit_frame.h>
 #include <class_board.h>
 #include <class_module.h>
-#include <rect_placement/rect_placement.h>
 
-struct TSubRect : public CRectPlacement::TRect
-{
-    int n;      // Original index of this subrect, before sorting
-
-    TSubRect() : TRect(),
-        n( 0 )
-    {
-    }
-
-    TSubRect( int _w, int _h, int _n ) :
-        TRect( 0, 0, _w, _h ), n( _n ) { }
-};
-
-typedef std::vector<TSubRect> CSubRectArray;
-
-// Use 0.01 mm units to calculate placement, to avoid long calculation time
-const int scale = (int)(0.01 * IU_PER_MM);
+#include "rect_packer.h"
+#include "spread_footprints.h"
 
 const int PADDING = (int)(1 * IU_PER_MM);
 
-// Populates a list of rectangles, from a list of modules
-void fillRectList( CSubRectArray& vecSubRects, std::vector <MODULE*>& aModuleList )
-{
-    vecSubRects.clear();
+// Margin around the area of each sheet
+const int SHEET_MARGIN = (int)(1.5 * IU_PER_MM);
 
-    for( unsigned ii = 0; ii < aModuleList.size(); ii++ )
-    {
-        EDA_RECT fpBox = aModuleList[ii]->GetFootprintRect();
-        TSubRect fpRect( ( fpBox.GetWidth() + PADDING ) / scale,
-                         ( fpBox.GetHeight() + PADDING ) / scale, ii );
-        vecSubRects.push_back( fpRect );
-    }
-}
 
-// Populates a list of rectangles, from a list of EDA_RECT
-void fillRectList( CSubRectArray& vecSubRects, std::vector <EDA_RECT>& aRectList )
+// A footprint to spread, with the data used to place it computed once
+struct SPREAD_ITEM
 {
-    vecSubRects.clear();
-
-    for( unsigned ii = 0; ii < aRectList.size(); ii++ )
-    {
-        EDA_RECT& rect = aRectList[ii];
-        TSubRect fpRect( rect.GetWidth()/scale, rect.GetHeight()/scale, ii );
-        vecSubRects.push_back( fpRect );
-    }
-}
-
+    MODULE*  m_footprint;
+    EDA_RECT m_bbox;        // footprint rect
+    wxString m_sheet;       // sheet path (the footprint path without its own time stamp)
+    size_t   m_pathLength;  // length of the full footprint path
+    wxPoint  m_pos;         // position of the footprint rect in the area of its sheet
+};
 
 
-// Spread a list of rectangles inside a placement area
-void spreadRectangles( CRectPlacement& aPlacementArea,
-                       CSubRectArray& vecSubRects,
-                       int areaSizeX, int areaSizeY )
+/**
+ * Packs rectangles of sizes aSizes in an area about 16/9 as wide as high.
+ * @param aPositions receives the positions of the upper left corners of the rectangles.
+ * @return the size of the area covered by the rectangles.
+ */
+static wxSize packRectangles( const std::vector<wxSize>& aSizes,
+                              std::vector<wxPoint>& aPositions )
 {
-    areaSizeX/= scale;
-    areaSizeY/= scale;
-
-    // Sort the subRects based on dimensions, larger dimension goes first.
-    std::sort( vecSubRects.begin(), vecSubRects.end(), CRectPlacement::TRect::Greater );
-
-    // gives the initial size to the area
-    aPlacementArea.Init( areaSizeX, areaSizeY );
+    double surface = 0.0;
+    int    maxWidth = 0;
 
-    // Add all subrects
-    CSubRectArray::iterator it;
-    for( it = vecSubRects.begin(); it != vecSubRects.end(); )
+    for( const wxSize& size : aSizes )
     {
-        CRectPlacement::TRect r( 0, 0, it->w, it->h );
-
-        bool bPlaced = aPlacementArea.AddAtEmptySpotAutoGrow( &r, areaSizeX, areaSizeY );
-
-        if( !bPlaced )   // No room to place the rectangle: enlarge area and retry
-        {
-            areaSizeX = ceil(areaSizeX * 1.1);
-            areaSizeY = ceil(areaSizeY * 1.1);
-            aPlacementArea.Init( areaSizeX, areaSizeY );
-            it = vecSubRects.begin();
-            continue;
-        }
-
-        // When correctly placed in a placement area, the coords are returned in r.x and r.y
-        // Store them.
-        it->x   = r.x;
-        it->y   = r.y;
-
-        it++;
+        surface += (double) size.x * size.y;
+        maxWidth = std::max( maxWidth, size.x );
     }
-}
 
+    double width = std::min( sqrt( surface ) * 4.0 / 3.0, (double) INT_MAX / 2 );
 
-void moveFootprintsInArea( CRectPlacement& aPlacementArea,
-                           std::vector <MODULE*>& aModuleList,
-                           EDA_RECT& aFreeArea,
-                           bool aFindAreaOnly )
-{
-    CSubRectArray   vecSubRects;
+    // Place the higher rectangles first: the skyline stays flat
+    std::vector<size_t> order( aSizes.size() );
+    std::iota( order.begin(), order.end(), 0 );
 
-    fillRectList( vecSubRects, aModuleList );
-    spreadRectangles( aPlacementArea, vecSubRects,
-                      aFreeArea.GetWidth(), aFreeArea.GetHeight() );
+    std::stable_sort( order.begin(), order.end(),
+            [&]( size_t a, size_t b )
+            {
+                if( aSizes[a].y != aSizes[b].y )
+                    return aSizes[a].y > aSizes[b].y;
 
-    if( aFindAreaOnly )
-        return;
+                return aSizes[a].x > aSizes[b].x;
+            } );
 
-    for( unsigned it = 0; it < vecSubRects.size(); ++it )
-    {
-        wxPoint pos( vecSubRects[it].x, vecSubRects[it].y );
-        pos.x *= scale;
-        pos.y *= scale;
+    RECT_PACKER packer( std::max( maxWidth, (int) width ) );
 
-        MODULE * module = aModuleList[vecSubRects[it].n];
+    aPositions.resize( aSizes.size() );
 
-        EDA_RECT fpBBox = module->GetFootprintRect();
-        wxPoint mod_pos = pos + ( module->GetPosition() - fpBBox.GetOrigin() )
-                          + aFreeArea.GetOrigin();
+    for( size_t ii : order )
+        aPositions[ii] = packer.Insert( aSizes[ii] );
 
-        module->Move( mod_pos - module->GetPosition() );
-    }
+    return packer.GetSize();
 }
 
-static bool sortFootprintsbySheetPath( MODULE* ref, MODULE* compare );
-
 
 /**
  * Footprints (after loaded by reading a netlist for instance) are moved
@@ -179,8 +121,7 @@ void SpreadFootprints( std::vector<MODULE*>* aFootprints,
                        wxPoint aSpreadAreaPosition )
 {
     // Build candidate list
-    // calculate also the area needed by these footprints
-    std::vector <MODULE*> footprintList;
+    std::vector<SPREAD_ITEM> items;
 
     for( MODULE* footprint : *aFootprints )
     {
@@ -188,123 +129,80 @@ void SpreadFootprints( std::vector<MODULE*>* aFootprints,
             continue;
 
         footprint->CalculateBoundingBox();
-        footprintList.push_back( footprint );
+
+        SPREAD_ITEM item;
+        item.m_footprint = footprint;
+        item.m_bbox = footprint->GetFootprintRect();
+        item.m_sheet = footprint->GetPath().BeforeLast( '/' );
+        item.m_pathLength = footprint->GetPath().Length();
+        items.push_back( item );
     }
 
-    if( footprintList.empty() )
+    if( items.empty() )
         return;
 
     // sort footprints by sheet path. we group them later by sheet
-    sort( footprintList.begin(), footprintList.end(), sortFootprintsbySheetPath );
-
-    // Extract and place footprints by sheet
-    std::vector <MODULE*> footprintListBySheet;
-    std::vector <EDA_RECT> placementSheetAreas;
-    double subsurface;
-    double placementsurface = 0.0;
-
-    // The placement uses 2 passes:
-    // the first pass creates the rectangular areas to place footprints
-    // each sheet in schematic creates one rectangular area.
-    // the second pass moves footprints inside these areas
-    for( int pass = 0; pass < 2; pass++ )
+    // (the full sheet path restricted to the time stamp of the sheet itself,
+    // without the time stamp of the footprint ).
+    std::stable_sort( items.begin(), items.end(),
+            []( const SPREAD_ITEM& ref, const SPREAD_ITEM& compare )
+            {
+                if( ref.m_pathLength == compare.m_pathLength )
+                    return ref.m_sheet.Cmp( compare.m_sheet ) < 0;
+
+                return ref.m_pathLength < compare.m_pathLength;
+            } );
+
+    // The placement is made in 2 steps:
+    // the footprints of each sheet in schematic are packed in a rectangular area,
+    // then the sheet areas are packed together.
+    std::vector<wxSize>  sheetSizes;
+    std::vector<size_t>  sheetStarts;
+    std::vector<wxSize>  sizes;
+    std::vector<wxPoint> positions;
+
+    for( size_t first = 0; first < items.size(); )
     {
-        int subareaIdx = 0;
-        footprintListBySheet.clear();
-        subsurface = 0.0;
+        size_t last = first + 1;
 
-        for( unsigned ii = 0; ii < footprintList.size(); ii++ )
-        {
-            MODULE* footprint = footprintList[ii];
-            bool islastItem = false;
+        while( last < items.size() && items[last].m_sheet == items[first].m_sheet )
+            last++;
 
-            if( ii == footprintList.size() - 1 ||
-                ( footprintList[ii]->GetPath().BeforeLast( '/' ) !=
-                  footprintList[ii+1]->GetPath().BeforeLast( '/' ) ) )
-                islastItem = true;
+        sizes.clear();
 
-            footprintListBySheet.push_back( footprint );
-            subsurface += footprint->GetArea( PADDING );
+        for( size_t ii = first; ii < last; ii++ )
+            sizes.emplace_back( items[ii].m_bbox.GetWidth() + PADDING,
+                                items[ii].m_bbox.GetHeight() + PADDING );
 
-            if( islastItem )
-            {
-                // end of the footprint sublist relative to the same sheet path
-                // calculate placement of the current sublist
-                EDA_RECT freeArea;
-                int Xsize_allowed = (int) ( sqrt( subsurface ) * 4.0 / 3.0 );
-                int Ysize_allowed = (int) ( subsurface / Xsize_allowed );
-
-                freeArea.SetWidth( Xsize_allowed );
-                freeArea.SetHeight( Ysize_allowed );
-                CRectPlacement placementArea;
-
-                if( pass == 1 )
-                {
-                    wxPoint areapos = placementSheetAreas[subareaIdx].GetOrigin()
-                                      + aSpreadAreaPosition;
-                    freeArea.SetOrigin( areapos );
-                }
-
-                bool findAreaOnly = pass == 0;
-                moveFootprintsInArea( placementArea, footprintListBySheet,
-                                      freeArea, findAreaOnly );
-
-                if( pass == 0 )
-                {
-                    // Populate sheet placement areas list
-                    EDA_RECT sub_area;
-                    sub_area.SetWidth( placementArea.GetW()*scale );
-                    sub_area.SetHeight( placementArea.GetH()*scale );
-                    // Add a margin around the sheet placement area:
-                    sub_area.Inflate( Millimeter2iu( 1.5 ) );
-
-                    placementSheetAreas.push_back( sub_area );
-
-                    placementsurface += (double) sub_area.GetWidth()*
-                                        sub_area.GetHeight();
-                }
-
-                // Prepare buffers for next sheet
-                subsurface  = 0.0;
-                footprintListBySheet.clear();
-                subareaIdx++;
-            }
-        }
+        wxSize sheetSize = packRectangles( sizes, positions );
 
-        // End of pass:
-        // At the end of the first pass, we have to find position of each sheet
-        // placement area
-        if( pass == 0 )
-        {
-            int Xsize_allowed = (int) ( sqrt( placementsurface ) * 4.0 / 3.0 );
-            int Ysize_allowed = (int) ( placementsurface / Xsize_allowed );
-            CRectPlacement placementArea;
-            CSubRectArray  vecSubRects;
+        for( size_t ii = first; ii < last; ii++ )
+            items[ii].m_pos = positions[ii - first];
 
-            fillRectList( vecSubRects, placementSheetAreas );
-            spreadRectangles( placementArea, vecSubRects, Xsize_allowed, Ysize_allowed );
+        // Add a margin around the sheet placement area:
+        sheetSizes.emplace_back( sheetSize.x + 2 * SHEET_MARGIN, sheetSize.y + 2 * SHEET_MARGIN );
+        sheetStarts.push_back( first );
 
-            for( unsigned it = 0; it < vecSubRects.size(); ++it )
-            {
-                TSubRect& srect = vecSubRects[it];
-                wxPoint pos( srect.x*scale, srect.y*scale );
-                wxSize size( srect.w*scale, srect.h*scale );
-                placementSheetAreas[srect.n].SetOrigin( pos );
-                placementSheetAreas[srect.n].SetSize( size );
-            }
-        }
-    }   // End pass
-}
+        first = last;
+    }
 
+    std::vector<wxPoint> sheetPositions;
 
-// Sort function, used to group footprints by sheet.
-// Footprints are sorted by their sheet path.
-// (the full sheet path restricted to the time stamp of the sheet itself,
-// without the time stamp of the footprint ).
-static bool sortFootprintsbySheetPath( MODULE* ref, MODULE* compare )
-{
-    if( ref->GetPath().Length() == compare->GetPath().Length() )
-        return ref->GetPath().BeforeLast( '/' ).Cmp( compare->GetPath().BeforeLast( '/' ) ) < 0;
+    packRectangles( sheetSizes, sheetPositions );
 
-    return ref->GetPath().Length() < compare->GetPath().Length();
+    // Move the footprints to their final place
+    sheetStarts.push_back( items.size() );
+
+    for( size_t sheet = 0; sheet < sheetSizes.size(); sheet++ )
+    {
+        wxPoint origin = aSpreadAreaPosition + sheetPositions[sheet]
+                         + wxPoint( SHEET_MARGIN, SHEET_MARGIN );
+
+        for( size_t ii = sheetStarts[sheet]; ii < sheetStarts[sheet + 1]; ii++ )
+        {
+            SPREAD_ITEM& item = items[ii];
+
+            item.m_footprint->Move( origin + item.m_pos - item.m_bbox.GetOrigin() );
+        }
+    }
 }
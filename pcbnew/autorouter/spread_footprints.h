@@ -0,0 +1,42 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SPREAD_FOOTPRINTS_H
+#define __SPREAD_FOOTPRINTS_H
+
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+class MODULE;
+
+/**
+ * Function SpreadFootprints
+ * moves the footprints of aFootprints (except the locked ones) next to each other without
+ * overlapping, grouped by schematic sheet, in an area whose upper left corner is
+ * aSpreadAreaPosition. Used to separate the footprints stacked at the same place after
+ * reading a netlist.
+ */
+void SpreadFootprints( std::vector<MODULE*>* aFootprints, wxPoint aSpreadAreaPosition );
+
+#endif    // __SPREAD_FOOTPRINTS_H
@@ -0,0 +1,54 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <board_change_log.h>
+#include <class_board_item.h>
+#include <undo_redo_container.h>
+
+
+void BOARD_CHANGE_LOG::RecordModified( const PICKED_ITEMS_LIST& aItems )
+{
+    for( unsigned ii = 0; ii < aItems.GetCount(); ii++ )
+    {
+        UNDO_REDO_T status = aItems.GetPickedItemStatus( ii );
+
+        if( status == UR_UNSPECIFIED )
+            status = aItems.m_Status;
+
+        switch( status )
+        {
+        case UR_CHANGED:
+        case UR_MOVED:
+        case UR_ROTATED:
+        case UR_ROTATED_CLOCKWISE:
+        case UR_FLIPPED:
+            if( auto item = dynamic_cast<BOARD_ITEM*>( aItems.GetPickedItem( ii ) ) )
+                Record( item, MODIFIED );
+
+            break;
+
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __BOARD_CHANGE_LOG_H
+#define __BOARD_CHANGE_LOG_H
+
+#include <cstdint>
+#include <vector>
+
+class BOARD_ITEM;
+class PICKED_ITEMS_LIST;
+
+/**
+ * Class BOARD_CHANGE_LOG
+ *
+ * Records the items added to, removed from and modified on a board, so that clients keeping
+ * their own copy of the board (such as the interactive router world) can update it instead
+ * of rebuilding it. Every change gets a serial number; clients remember the serial of the
+ * first change they have not applied yet.
+ *
+ * The items of removed entries may have been freed: clients must not dereference them.
+ */
+class BOARD_CHANGE_LOG
+{
+public:
+    enum CHANGE_TYPE
+    {
+        ADDED,
+        REMOVED,
+        MODIFIED
+    };
+
+    struct CHANGE
+    {
+        BOARD_ITEM* m_item;
+        CHANGE_TYPE m_type;
+    };
+
+    BOARD_CHANGE_LOG() :
+        m_first( 0 )
+    {}
+
+    void Record( BOARD_ITEM* aItem, CHANGE_TYPE aType )
+    {
+        // Past this size, rebuilding the copies is cheaper than replaying the changes
+        if( m_changes.size() >= MAX_CHANGES )
+            Invalidate();
+
+        m_changes.push_back( { aItem, aType } );
+    }
+
+    /**
+     * Function RecordModified()
+     *
+     * Records the items of an undo entry changed in place (UR_CHANGED, UR_MOVED, ...), for
+     * the code saving its changes in the undo list instead of pushing a BOARD_COMMIT.
+     */
+    void RecordModified( const PICKED_ITEMS_LIST& aItems );
+
+    /**
+     * Function Invalidate()
+     *
+     * Drops the recorded changes, for instance after the board was changed without
+     * recording: the clients have to rebuild their copies.
+     */
+    void Invalidate()
+    {
+        m_first = Serial() + 1;
+        m_changes.clear();
+    }
+
+    ///> Returns the serial number of the next change.
+    uint64_t Serial() const
+    {
+        return m_first + m_changes.size();
+    }
+
+    /**
+     * Function ChangesSince()
+     *
+     * Appends to aChanges the changes recorded from serial aSerial on.
+     * @return false if some of these changes were dropped.
+     */
+    bool ChangesSince( uint64_t aSerial, std::vector<CHANGE>& aChanges ) const
+    {
+        if( aSerial < m_first || aSerial > Serial() )
+            return false;
+
+        aChanges.insert( aChanges.end(), m_changes.begin() + ( aSerial - m_first ),
+                         m_changes.end() );
+        return true;
+    }
+
+private:
+    static const size_t MAX_CHANGES = 100000;
+
+    std::vector<CHANGE> m_changes;
+
+    ///> serial number of m_changes[0]
+    uint64_t            m_first;
+};
+
+#endif    // __BOARD_CHANGE_LOG_H
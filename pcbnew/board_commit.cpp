@@ -131,6 +131,8 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 savedModules.insert( ent.m_item );
                 static_cast<MODULE*>( ent.m_item )->SetLastEditTime();
+                board->ChangeLog().Record( static_cast<BOARD_ITEM*>( ent.m_item ),
+                                           BOARD_CHANGE_LOG::MODIFIED );
             }
         }
 
@@ -255,6 +257,7 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 connectivity->Update( boardItem );
                 view->Update( boardItem );
+                board->ChangeLog().Record( boardItem, BOARD_CHANGE_LOG::MODIFIED );
 
                 // if no undo entry is needed, the copy would create a memory leak
                 if( !aCreateUndoEntry )
@@ -288,6 +291,8 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 auto boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+                board->ChangeLog().Record( boardItem, BOARD_CHANGE_LOG::MODIFIED );
+
                 if( aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
@@ -388,6 +393,7 @@ void BOARD_COMMIT::Revert()
 
             view->Add( item );
             connectivity->Add( item );
+            board->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
             delete copy;
             break;
         }
@@ -597,6 +597,7 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, ADD_MODE aMode )
     aBoardItem->SetParent( this );
     aBoardItem->ClearEditFlags();
     m_connectivity->Add( aBoardItem );
+    m_changeLog.Record( aBoardItem, BOARD_CHANGE_LOG::ADDED );
 }
 
 
@@ -667,6 +668,7 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
     }
 
     m_connectivity->Remove( aBoardItem );
+    m_changeLog.Record( aBoardItem, BOARD_CHANGE_LOG::REMOVED );
 }
 
 
@@ -1806,6 +1808,16 @@ void BOARD::SanitizeNetcodes()
     for ( BOARD_CONNECTED_ITEM* item : AllConnectedItems() )
     {
         if( FindNet( item->GetNetCode() ) == nullptr )
+        {
             item->SetNetCode( NETINFO_LIST::ORPHANED );
+
+            // Pads are logged through their footprint
+            BOARD_ITEM* changed = item;
+
+            if( item->Type() == PCB_PAD_T )
+                changed = static_cast<BOARD_ITEM*>( item->GetParent() );
+
+            m_changeLog.Record( changed, BOARD_CHANGE_LOG::MODIFIED );
+        }
     }
 }
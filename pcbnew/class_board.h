@@ -27,6 +27,7 @@
 
 #include <tuple>
 #include <core/iterators.h>
+#include <board_change_log.h>
 #include <board_design_settings.h>
 #include <board_item_container.h>
 #include <class_module.h>
@@ -191,6 +192,8 @@ private:
 
     std::shared_ptr<CONNECTIVITY_DATA>      m_connectivity;
 
+    BOARD_CHANGE_LOG        m_changeLog;
+
     BOARD_DESIGN_SETTINGS   m_designSettings;
     PCB_GENERAL_SETTINGS*   m_generalSettings;      ///< reference only; I have no ownership
     PAGE_INFO               m_paper;
@@ -303,6 +306,17 @@ public:
         return m_connectivity;
     }
 
+    /**
+     * Function ChangeLog()
+     * returns the log of the items added, removed and modified since the board was loaded.
+     * Add() and Remove() record their changes, modifications are recorded by the code
+     * making them (BOARD_COMMIT, undo/redo).
+     */
+    BOARD_CHANGE_LOG& ChangeLog()
+    {
+        return m_changeLog;
+    }
+
     /**
      * Builds or rebuilds the board connectivity database for the board,
      * especially the list of connected items, list of nets and rastnest data
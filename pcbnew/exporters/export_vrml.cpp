@@ -27,7 +27,9 @@
 #include <cmath>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iomanip>
+#include <memory>
 #include <vector>
 #include <wx/dir.h>
 
@@ -60,6 +62,8 @@
 #define  ART_OFFSET 0.025
 // offset for plating
 #define  PLATE_OFFSET 0.005
+// maximum number of board layers tesselated and not yet written out
+#define  MAX_LAYERS_IN_FLIGHT 3
 
 static S3D_CACHE* cache;
 static bool USE_INLINES;            // true to use legacy inline{} behavior
@@ -419,144 +423,134 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 }
 
 
+// one board layer to be tesselated and written out
+struct VRML_LAYER_JOB
+{
+    VRML_LAYER*      m_layer;
+    VRML_COLOR_INDEX m_color;
+    bool             m_plane;       // true for a plane, false for a shell
+    bool             m_top;         // plane facing up
+    double           m_top_z;
+    double           m_bottom_z;    // only used by shells
+    bool             m_holesOnly;   // tesselate the layer's own holes only (plated holes)
+    std::unique_ptr<VRML_LAYER> m_holes;    // private copy of the board holes
+};
+
+
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     const char* aFileName, OSTREAM* aOutputFile )
 {
-    // VRML_LAYER board;
-    aModel.m_board.Tesselate( &aModel.m_holes );
     double brdz = aModel.m_brd_thickness / 2.0
                   - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * BOARD_SCALE;
+    double tin_offset = Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE;
+
+    // The layers in output order
+    std::vector<VRML_LAYER_JOB> jobs;
+
+    auto addJob = [&]( VRML_LAYER& aLayer, VRML_COLOR_INDEX aColor, bool aPlane, bool aTop,
+                       double aTopZ, double aBottomZ, bool aHolesOnly )
+    {
+        VRML_LAYER_JOB job;
+        job.m_layer = &aLayer;
+        job.m_color = aColor;
+        job.m_plane = aPlane;
+        job.m_top = aTop;
+        job.m_top_z = aTopZ;
+        job.m_bottom_z = aBottomZ;
+        job.m_holesOnly = aHolesOnly;
+        jobs.push_back( std::move( job ) );
+    };
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_PCB ),
-                            &aModel.m_board, false, false, brdz, -brdz );
-    }
-    else
-    {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_PCB, &aModel.m_board, brdz, -brdz );
-    }
-
-    if( aModel.m_plainPCB )
-    {
-        if( !USE_INLINES )
-            S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), USE_DEFS, true );
-
-        return;
-    }
-
-    // VRML_LAYER m_top_copper;
-    aModel.m_top_copper.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
-                           &aModel.m_top_copper, true, true,
-                           aModel.GetLayerZ( F_Cu ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_top_copper,
-                           aModel.GetLayerZ( F_Cu ), true );
-    }
-
-    // VRML_LAYER m_top_tin;
-    aModel.m_top_tin.Tesselate( &aModel.m_holes );
+    addJob( aModel.m_board, VRML_COLOR_PCB, false, false, brdz, -brdz, false );
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_top_tin, true, true,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            0 );
-    }
-    else
+    if( !aModel.m_plainPCB )
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_top_tin,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           true );
-    }
-
-    // VRML_LAYER m_bot_copper;
-    aModel.m_bot_copper.Tesselate( &aModel.m_holes );
+        addJob( aModel.m_top_copper, VRML_COLOR_TRACK, true, true,
+                aModel.GetLayerZ( F_Cu ), 0, false );
+        addJob( aModel.m_top_tin, VRML_COLOR_TIN, true, true,
+                aModel.GetLayerZ( F_Cu ) + tin_offset, 0, false );
+        addJob( aModel.m_bot_copper, VRML_COLOR_TRACK, true, false,
+                aModel.GetLayerZ( B_Cu ), 0, false );
+        addJob( aModel.m_bot_tin, VRML_COLOR_TIN, true, false,
+                aModel.GetLayerZ( B_Cu ) - tin_offset, 0, false );
+        addJob( aModel.m_plated_holes, VRML_COLOR_TIN, false, false,
+                aModel.GetLayerZ( F_Cu ) + tin_offset,
+                aModel.GetLayerZ( B_Cu ) - tin_offset, true );
+        addJob( aModel.m_top_silk, VRML_COLOR_SILK, true, true,
+                aModel.GetLayerZ( F_SilkS ), 0, false );
+        addJob( aModel.m_bot_silk, VRML_COLOR_SILK, true, false,
+                aModel.GetLayerZ( B_SilkS ), 0, false );
+    }
+
+    // The tesselator renumbers the vertices of the holes object, and the
+    // results are only valid until the next tesselation using it, so every
+    // layer is tesselated against its own copy of the holes. The board holes
+    // themselves are only read, from the worker threads.
+    std::vector<std::future<void>> tesselated( jobs.size() );
+
+    auto startJob = [&]( size_t aIndex )
+    {
+        VRML_LAYER_JOB* job = &jobs[aIndex];
+        VRML_LAYER*     boardHoles = &aModel.m_holes;
+
+        tesselated[aIndex] = std::async( std::launch::async, [job, boardHoles]()
+        {
+            if( job->m_holesOnly )
+            {
+                job->m_layer->Tesselate( NULL, true );
+            }
+            else
+            {
+                job->m_holes.reset( new VRML_LAYER );
+                job->m_holes->CopyContours( *boardHoles );
+                job->m_layer->Tesselate( job->m_holes.get() );
+            }
+        } );
+    };
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
-                            &aModel.m_bot_copper, true, false,
-                            aModel.GetLayerZ( B_Cu ), 0 );
-    }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_bot_copper,
-                           aModel.GetLayerZ( B_Cu ), false );
-    }
+    // Only a few layers are tesselated ahead of the one being written, so the
+    // tesselations and hole copies held at once stay bounded
+    size_t nextJob = 0;
 
-    // VRML_LAYER m_bot_tin;
-    aModel.m_bot_tin.Tesselate( &aModel.m_holes );
+    for( ; nextJob < jobs.size() && nextJob < MAX_LAYERS_IN_FLIGHT; ++nextJob )
+        startJob( nextJob );
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_bot_tin, true, false,
-                            aModel.GetLayerZ( B_Cu )
-                            - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            0 );
-    }
-    else
+    // Write the layers in order as soon as they are ready. Each layer is
+    // released once written, and its slot given to the next layer.
+    for( size_t i = 0; i < jobs.size(); ++i )
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_bot_tin,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           false );
-    }
+        VRML_LAYER_JOB& job = jobs[i];
 
-    // VRML_LAYER PTH;
-    aModel.m_plated_holes.Tesselate( NULL, true );
+        tesselated[i].wait();
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
-                            &aModel.m_plated_holes, false, false,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
-    }
-    else
-    {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_plated_holes,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
-    }
+        if( USE_INLINES )
+        {
+            write_triangle_bag( *aOutputFile, aModel.GetColor( job.m_color ), job.m_layer,
+                                job.m_plane, job.m_top, job.m_top_z, job.m_bottom_z );
+        }
+        else if( job.m_plane )
+        {
+            create_vrml_plane( aModel.m_OutputPCB, job.m_color, job.m_layer,
+                               job.m_top_z, job.m_top );
+        }
+        else
+        {
+            create_vrml_shell( aModel.m_OutputPCB, job.m_color, job.m_layer,
+                               job.m_top_z, job.m_bottom_z );
+        }
 
-    // VRML_LAYER m_top_silk;
-    aModel.m_top_silk.Tesselate( &aModel.m_holes );
+        job.m_layer->Clear();
+        job.m_holes.reset();
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_top_silk,
-                            true, true, aModel.GetLayerZ( F_SilkS ), 0 );
+        if( nextJob < jobs.size() )
+            startJob( nextJob++ );
     }
-    else
-    {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_top_silk,
-                           aModel.GetLayerZ( F_SilkS ), true );
-    }
-
-    // VRML_LAYER m_bot_silk;
-    aModel.m_bot_silk.Tesselate( &aModel.m_holes );
 
-    if( USE_INLINES )
-    {
-        write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_bot_silk,
-                            true, false, aModel.GetLayerZ( B_SilkS ), 0 );
-    }
-    else
+    if( !USE_INLINES )
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_bot_silk,
-                           aModel.GetLayerZ( B_SilkS ), false );
+        S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(),
+                        aModel.m_plainPCB ? USE_DEFS : true, true );
     }
-
-    if( !USE_INLINES )
-        S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), true, true );
 }
 
 
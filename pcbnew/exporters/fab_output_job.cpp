@@ -0,0 +1,402 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fab_output_job.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include <fctsys.h>
+#include <common.h>
+#include <plotter.h>
+#include <profile.h>
+#include <reporter.h>
+#include <wildcards_and_files_ext.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <pcbplot.h>
+
+#include <exporters/export_footprints_placefile.h>
+#include <exporters/fab_output_job.h>
+#include <exporters/gendrill_Excellon_writer.h>
+#include <exporters/gendrill_gerber_writer.h>
+#include <exporters/gerber_jobfile_writer.h>
+#include <exporters/gerber_placefile_writer.h>
+
+
+/**
+ * Keeps the messages of a task, to pass them to the job reporter once all the tasks are
+ * done: reporters are not thread safe, and the messages stay in the order of the files.
+ */
+class TASK_REPORTER : public REPORTER
+{
+public:
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.emplace_back( aText, aSeverity );
+        return *this;
+    }
+
+    bool HasMessage() const override
+    {
+        return !m_messages.empty();
+    }
+
+    void Forward( REPORTER* aReporter ) const
+    {
+        if( !aReporter )
+            return;
+
+        for( const auto& msg : m_messages )
+            aReporter->Report( msg.first, msg.second );
+    }
+
+private:
+    std::vector<std::pair<wxString, SEVERITY>> m_messages;
+};
+
+
+struct FAB_OUTPUT_JOB::TASK
+{
+    enum TASK_TYPE
+    {
+        PLOT_LAYER,
+        DRILL_FILES,
+        PLACEMENT_FILE
+    };
+
+    TASK( TASK_TYPE aType, PCB_LAYER_ID aLayer, const wxString& aFileName ) :
+        m_type( aType ),
+        m_layer( aLayer ),
+        m_fileName( aFileName ),
+        m_success( false )
+    {}
+
+    TASK_TYPE     m_type;
+
+    ///> layer to plot, or side (F_Cu or B_Cu) of the placement file
+    PCB_LAYER_ID  m_layer;
+
+    ///> full name of the file to create, or output directory of the drill files
+    wxString      m_fileName;
+
+    bool          m_success;
+    TASK_REPORTER m_reporter;
+};
+
+
+FAB_OUTPUT_JOB::FAB_OUTPUT_JOB( BOARD* aBoard ) :
+    m_board( aBoard ),
+    m_plotOptions( aBoard->GetPlotOptions() ),
+    m_layers( m_plotOptions.GetLayerSelection() ),
+    m_drillFormat( EXCELLON_DRILL_FILES ),
+    m_drillMetric( true ),
+    m_mergePTH_NPTH( false ),
+    m_drillMap( false ),
+    m_placementFormat( NO_PLACEMENT_FILES ),
+    m_placementUnitsMM( true ),
+    m_threadCount( 0 )
+{
+}
+
+
+void FAB_OUTPUT_JOB::buildTasks( const wxString& aOutputDir, std::vector<TASK>& aTasks ) const
+{
+    wxString boardFilename = m_board->GetFileName();
+    wxString fileExt = GetDefaultPlotExtension( m_plotOptions.GetFormat() );
+
+    // The drill files are a single task: start it first, so it runs along the layer plots
+    if( m_drillFormat != NO_DRILL_FILES )
+        aTasks.emplace_back( TASK::DRILL_FILES, UNDEFINED_LAYER, aOutputDir );
+
+    for( LSEQ seq = m_layers.UIOrder(); seq; ++seq )
+    {
+        PCB_LAYER_ID layer = *seq;
+
+        // Same as the plot dialog: skip the copper layers disabled on the board
+        if( ( LSET::AllCuMask() & ~m_board->GetEnabledLayers() )[layer] )
+            continue;
+
+        wxFileName fn( boardFilename );
+
+        if( m_plotOptions.GetFormat() == PLOT_FORMAT_GERBER
+                && m_plotOptions.GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, aOutputDir, m_board->GetLayerName( layer ), fileExt );
+        aTasks.emplace_back( TASK::PLOT_LAYER, layer, fn.GetFullPath() );
+    }
+
+    if( m_placementFormat == NO_PLACEMENT_FILES )
+        return;
+
+    for( PCB_LAYER_ID side : { F_Cu, B_Cu } )
+    {
+        wxFileName fn( boardFilename );
+        fn.SetPath( aOutputDir );
+
+        if( m_placementFormat == GERBER_PLACEMENT_FILES )
+        {
+            PLACEFILE_GERBER_WRITER writer( m_board );
+            aTasks.emplace_back( TASK::PLACEMENT_FILE, side,
+                                 writer.GetPlaceFileName( fn.GetFullPath(), side ) );
+            continue;
+        }
+
+        // Same names as the placement dialog
+        std::string sideName = ( side == F_Cu ) ? PLACE_FILE_EXPORTER::GetFrontSideName()
+                                                : PLACE_FILE_EXPORTER::GetBackSideName();
+
+        fn.SetName( fn.GetName() + wxT( "-" ) + sideName.c_str() );
+
+        if( m_placementFormat == CSV_PLACEMENT_FILES )
+        {
+            fn.SetName( fn.GetName() + wxT( "-" ) + FootprintPlaceFileExtension );
+            fn.SetExt( wxT( "csv" ) );
+        }
+        else
+        {
+            fn.SetExt( FootprintPlaceFileExtension );
+        }
+
+        aTasks.emplace_back( TASK::PLACEMENT_FILE, side, fn.GetFullPath() );
+    }
+}
+
+
+void FAB_OUTPUT_JOB::plotLayer( TASK& aTask ) const
+{
+    // Every task plots with its own copy of the options, as the plotters may change them
+    PCB_PLOT_PARAMS plotOpts = m_plotOptions;
+    wxString        msg;
+
+    PLOTTER* plotter = StartPlotBoard( m_board, &plotOpts, aTask.m_layer, aTask.m_fileName,
+                                       wxEmptyString );
+
+    if( plotter )
+    {
+        PlotOneBoardLayer( m_board, plotter, aTask.m_layer, plotOpts );
+        plotter->EndPlot();
+        delete plotter;
+
+        msg.Printf( _( "Plot file \"%s\" created." ), aTask.m_fileName );
+        aTask.m_reporter.Report( msg, REPORTER::RPT_ACTION );
+        aTask.m_success = true;
+    }
+    else
+    {
+        msg.Printf( _( "Unable to create file \"%s\"." ), aTask.m_fileName );
+        aTask.m_reporter.Report( msg, REPORTER::RPT_ERROR );
+    }
+}
+
+
+void FAB_OUTPUT_JOB::createDrillFiles( TASK& aTask ) const
+{
+    wxPoint offset;
+
+    if( m_plotOptions.GetUseAuxOrigin() )
+        offset = m_board->GetAuxOrigin();
+
+    if( m_drillFormat == EXCELLON_DRILL_FILES )
+    {
+        EXCELLON_WRITER writer( m_board );
+        writer.SetFormat( m_drillMetric );
+        writer.SetOptions( false, false, offset, m_mergePTH_NPTH );
+        writer.CreateDrillandMapFilesSet( aTask.m_fileName, true, m_drillMap, &aTask.m_reporter );
+    }
+    else
+    {
+        GERBER_WRITER writer( m_board );
+        writer.SetFormat( m_plotOptions.GetGerberPrecision() );
+        writer.SetOptions( offset );
+        writer.CreateDrillandMapFilesSet( aTask.m_fileName, true, m_drillMap, &aTask.m_reporter );
+    }
+
+    // The drill writers only report the files they could not create
+    aTask.m_success = true;
+}
+
+
+void FAB_OUTPUT_JOB::createPlacementFile( TASK& aTask ) const
+{
+    wxString msg;
+    int      fpcount = -1;
+
+    if( m_placementFormat == GERBER_PLACEMENT_FILES )
+    {
+        // Builds the courtyards of the footprints of its own side only: the two sides
+        // touch disjoint footprints and can be created together
+        PLACEFILE_GERBER_WRITER writer( m_board );
+        fpcount = writer.CreatePlaceFile( aTask.m_fileName, aTask.m_layer, false );
+    }
+    else if( FILE* file = wxFopen( aTask.m_fileName, wxT( "wt" ) ) )
+    {
+        PLACE_FILE_EXPORTER exporter( m_board, m_placementUnitsMM, false,
+                                      aTask.m_layer == F_Cu, aTask.m_layer == B_Cu,
+                                      m_placementFormat == CSV_PLACEMENT_FILES );
+        std::string data = exporter.GenPositionData();
+
+        fputs( data.c_str(), file );
+        fclose( file );
+        fpcount = exporter.GetFootprintCount();
+    }
+
+    if( fpcount < 0 )
+    {
+        msg.Printf( _( "Unable to create file \"%s\"." ), aTask.m_fileName );
+        aTask.m_reporter.Report( msg, REPORTER::RPT_ERROR );
+        return;
+    }
+
+    msg.Printf( _( "Place file \"%s\" created, component count: %d." ), aTask.m_fileName,
+                fpcount );
+    aTask.m_reporter.Report( msg, REPORTER::RPT_ACTION );
+    aTask.m_success = true;
+}
+
+
+void FAB_OUTPUT_JOB::runTask( TASK& aTask ) const
+{
+    switch( aTask.m_type )
+    {
+    case TASK::PLOT_LAYER:     plotLayer( aTask );           break;
+    case TASK::DRILL_FILES:    createDrillFiles( aTask );    break;
+    case TASK::PLACEMENT_FILE: createPlacementFile( aTask ); break;
+    }
+}
+
+
+bool FAB_OUTPUT_JOB::Run( REPORTER* aReporter )
+{
+    PROF_COUNTER timer;
+
+    m_outputFiles.Clear();
+
+    // Ensure that the output directory exists (and make it absolute)
+    wxFileName outputDir = wxFileName::DirName( m_plotOptions.GetOutputDirectory() );
+
+    if( !EnsureFileDirectoryExists( &outputDir, m_board->GetFileName(), aReporter ) )
+    {
+        if( aReporter )
+        {
+            wxString msg;
+            msg.Printf( _( "Could not write plot files to folder \"%s\"." ),
+                        outputDir.GetPath() );
+            aReporter->Report( msg, REPORTER::RPT_ERROR );
+        }
+
+        return false;
+    }
+
+    std::vector<TASK> tasks;
+    buildTasks( outputDir.GetPath(), tasks );
+
+    // The pads compute their bounding radius on demand: do it now, before the threads
+    // read it
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->GetBoundingRadius();
+    }
+
+    // The locale is switched once for all the tasks: the LOCALE_IO objects of the plotters
+    // and writers only count the nested switches, which is thread safe
+    LOCALE_IO toggle;
+
+    std::atomic<size_t> nextItem( 0 );
+    size_t              parallelThreadCount = m_threadCount > 0
+                                                      ? (size_t) m_threadCount
+                                                      : std::thread::hardware_concurrency();
+    parallelThreadCount = std::min<size_t>( parallelThreadCount, tasks.size() );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto task_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < tasks.size(); i = nextItem++ )
+        {
+            runTask( tasks[i] );
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        task_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, task_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    bool success = true;
+    GERBER_JOBFILE_WRITER jobfile_writer( m_board, aReporter );
+
+    for( TASK& task : tasks )
+    {
+        task.m_reporter.Forward( aReporter );
+        success &= task.m_success;
+
+        if( !task.m_success || task.m_type == TASK::DRILL_FILES )
+            continue;
+
+        m_outputFiles.Add( task.m_fileName );
+
+        if( task.m_type == TASK::PLOT_LAYER )
+        {
+            wxString fullname = wxFileName( task.m_fileName ).GetFullName();
+            jobfile_writer.AddGbrFile( task.m_layer, fullname );
+        }
+    }
+
+    if( m_plotOptions.GetFormat() == PLOT_FORMAT_GERBER
+            && m_plotOptions.GetCreateGerberJobFile() )
+    {
+        wxFileName fn( m_board->GetFileName() );
+        BuildPlotFileName( &fn, outputDir.GetPath(), "job", GerberJobFileExtension );
+
+        if( jobfile_writer.CreateJobFile( fn.GetFullPath() ) )
+            m_outputFiles.Add( fn.GetFullPath() );
+        else
+            success = false;
+    }
+
+    timer.Stop();
+
+    wxLogTrace( "FAB_OUTPUT", "FAB_OUTPUT_JOB: %d files, %d threads, %.1f ms",
+                (int) tasks.size(), (int) parallelThreadCount, timer.msecs() );
+
+    return success;
+}
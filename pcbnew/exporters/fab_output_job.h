@@ -0,0 +1,164 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fab_output_job.h
+ * @brief Generation of the whole set of fabrication files of a board in parallel.
+ */
+
+#ifndef FAB_OUTPUT_JOB_H
+#define FAB_OUTPUT_JOB_H
+
+#include <vector>
+
+#include <wx/arrstr.h>
+
+#include <layers_id_colors_and_visibility.h>
+#include <pcb_plot_params.h>
+
+class BOARD;
+class REPORTER;
+
+/**
+ * Class FAB_OUTPUT_JOB
+ *
+ * Creates the fabrication files of a board: the plot files of the selected layers (usually
+ * Gerber files), the drill files, the Gerber job file and the placement files. Every file is
+ * generated by its own task, with its own plotter or writer, and the tasks run on worker
+ * threads. The files are the same as the ones created one after the other by the plot,
+ * drill and placement dialogs (or by PLOT_CONTROLLER and the drill writers in scripts).
+ *
+ * The board must not be modified while Run() is running. The page frames (PlotFrameRef) are
+ * built from the shared page layout, so the layer tasks plot them one at a time.
+ */
+class FAB_OUTPUT_JOB
+{
+public:
+    enum DRILL_FORMAT
+    {
+        NO_DRILL_FILES,
+        EXCELLON_DRILL_FILES,
+        GERBER_DRILL_FILES
+    };
+
+    enum PLACEMENT_FORMAT
+    {
+        NO_PLACEMENT_FILES,
+        ASCII_PLACEMENT_FILES,
+        CSV_PLACEMENT_FILES,
+        GERBER_PLACEMENT_FILES
+    };
+
+    /**
+     * Creates a job with the plot options and the layer selection stored in the board,
+     * Excellon drill files and no placement files.
+     */
+    FAB_OUTPUT_JOB( BOARD* aBoard );
+
+    /**
+     * Accessor to the plot options: the format, output directory and Gerber options
+     * of the layer plots. The Gerber job file is created if the format is Gerber and
+     * GetCreateGerberJobFile() is set.
+     */
+    PCB_PLOT_PARAMS& GetPlotOptions() { return m_plotOptions; }
+
+    void SetLayers( LSET aLayers ) { m_layers = aLayers; }
+    void AddLayer( PCB_LAYER_ID aLayer ) { m_layers.set( aLayer ); }
+    LSET GetLayers() const { return m_layers; }
+
+    void SetDrillFormat( DRILL_FORMAT aFormat ) { m_drillFormat = aFormat; }
+
+    /**
+     * Function SetDrillOptions
+     * @param aMetric = true for metric Excellon coordinates, false for inches
+     * @param aMerge_PTH_NPTH = true to create a single Excellon file for plated and
+     * non plated holes (Gerber drill files are always separate)
+     * @param aGenerateMap = true to create the drill map files too, in the format of
+     * SetMapFileFormat() of the drill writers (PDF)
+     */
+    void SetDrillOptions( bool aMetric, bool aMerge_PTH_NPTH, bool aGenerateMap )
+    {
+        m_drillMetric = aMetric;
+        m_mergePTH_NPTH = aMerge_PTH_NPTH;
+        m_drillMap = aGenerateMap;
+    }
+
+    /**
+     * Function SetPlacementFormat
+     * Placement files are created for the front and back sides.
+     * @param aFormat = the placement file format
+     * @param aUnitsMM = true for mm, false for inches (ASCII and CSV files only)
+     */
+    void SetPlacementFormat( PLACEMENT_FORMAT aFormat, bool aUnitsMM = true )
+    {
+        m_placementFormat = aFormat;
+        m_placementUnitsMM = aUnitsMM;
+    }
+
+    /**
+     * Function SetThreadCount
+     * @param aCount = maximum number of worker threads, 0 to use all the cores
+     */
+    void SetThreadCount( int aCount ) { m_threadCount = aCount; }
+
+    /**
+     * Function Run
+     * Creates all the files.
+     * @param aReporter = a REPORTER to return activity and error messages (can be NULL).
+     * The messages are reported once all the files are created, in the order of the files.
+     * @return true if all the files were created
+     */
+    bool Run( REPORTER* aReporter = nullptr );
+
+    /**
+     * @return the full names of the files created by the last Run()
+     */
+    wxArrayString GetOutputFiles() const { return m_outputFiles; }
+
+private:
+    struct TASK;
+
+    void buildTasks( const wxString& aOutputDir, std::vector<TASK>& aTasks ) const;
+    void runTask( TASK& aTask ) const;
+    void plotLayer( TASK& aTask ) const;
+    void createDrillFiles( TASK& aTask ) const;
+    void createPlacementFile( TASK& aTask ) const;
+
+    BOARD*           m_board;
+    PCB_PLOT_PARAMS  m_plotOptions;
+    LSET             m_layers;
+
+    DRILL_FORMAT     m_drillFormat;
+    bool             m_drillMetric;
+    bool             m_mergePTH_NPTH;
+    bool             m_drillMap;
+
+    PLACEMENT_FORMAT m_placementFormat;
+    bool             m_placementUnitsMM;
+
+    int              m_threadCount;
+
+    wxArrayString    m_outputFiles;
+};
+
+#endif  // FAB_OUTPUT_JOB_H
@@ -447,6 +447,7 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
     routeMenu->AddItem( PCB_ACTIONS::routerTuneSingleTrace,  SELECTION_CONDITIONS::ShowAlways );
     routeMenu->AddItem( PCB_ACTIONS::routerTuneDiffPair,     SELECTION_CONDITIONS::ShowAlways );
     routeMenu->AddItem( PCB_ACTIONS::routerTuneDiffPairSkew, SELECTION_CONDITIONS::ShowAlways );
+    routeMenu->AddItem( PCB_ACTIONS::routerTuneSelectedNets, SELECTION_CONDITIONS::NotEmpty );
 
     routeMenu->AddSeparator();
     routeMenu->AddItem( PCB_ACTIONS::routerSettingsDialog,   SELECTION_CONDITIONS::ShowAlways );
@@ -52,9 +52,7 @@ using namespace std::placeholders;
 #include <tools/pcb_actions.h>
 #include <tools/selection_tool.h>
 #include <view/view.h>
-
-extern void SpreadFootprints( std::vector<MODULE*>* aFootprints,
-                              wxPoint aSpreadAreaPosition );
+#include <autorouter/spread_footprints.h>
 
 
 bool PCB_EDIT_FRAME::ReadNetlistFromFile( const wxString &aFilename,
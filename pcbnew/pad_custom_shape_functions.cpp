@@ -348,8 +348,9 @@ bool D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon )
         maxError = board->GetDesignSettings().m_MaxError;
 
     // if aMergedPolygon == NULL, use m_customShapeAsPolygon as target
+    bool updateShape = !aMergedPolygon;
 
-    if( !aMergedPolygon )
+    if( updateShape )
         aMergedPolygon = &m_customShapeAsPolygon;
 
     aMergedPolygon->RemoveAllContours();
@@ -375,7 +376,10 @@ bool D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon )
     if( !buildCustomPadPolygon( aMergedPolygon, maxError ) )
         return false;
 
-    m_boundingRadius = -1;  // The current bounding radius is no longer valid.
+    // The current bounding radius is no longer valid. Filling another polygon leaves the pad
+    // unchanged, so pads shared by the plot threads can be converted.
+    if( updateShape )
+        m_boundingRadius = -1;
 
     return aMergedPolygon->OutlineCount() <= 1;
 }
@@ -355,7 +355,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+            // The pad is plotted with a modified size: work on a copy, so that the board
+            // is left untouched and can be plotted on several layers at the same time
+            D_PAD plotPad( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -388,7 +390,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                plotPad.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -405,30 +407,28 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                plotPad.SetSize( padPlotsSize );
 
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
                     ( aPlotOpt.GetDrillMarksType() == PCB_PLOT_PARAMS::NO_DRILL_SHAPE ) &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( plotPad.GetSize() == plotPad.GetDrillSize() ) &&
+                    ( plotPad.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, plotMode );
+                plotPad.SetSize( padPlotsSize );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
@@ -437,7 +437,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 // so build a similar pad shape, and inflate/deflate the polygonal shape
                 D_PAD dummy( *pad );
                 SHAPE_POLY_SET shape;
-                pad->MergePrimitivesAsPolygon( &shape );
+                dummy.MergePrimitivesAsPolygon( &shape );
                 // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
                 // which can create bad shapes if margin.x is < 0
                 int maxError = aBoard->GetDesignSettings().m_MaxError;
@@ -457,9 +457,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             }
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -33,8 +33,11 @@
 #include <tool/action_menu.h>
 #include <tool/tool_manager.h>
 #include <tools/pcb_actions.h>
+#include <tools/selection_tool.h>
+#include <confirm.h>
 #include "pns_segment.h"
 #include "pns_router.h"
+#include "pns_meander_batch.h"
 #include "pns_meander_placer.h" // fixme: move settings to separate header
 #include "pns_tune_status_popup.h"
 
@@ -138,8 +141,7 @@ LENGTH_TUNER_TOOL::~LENGTH_TUNER_TOOL()
 
 void LENGTH_TUNER_TOOL::Reset( RESET_REASON aReason )
 {
-    if( aReason == RUN )
-        TOOL_BASE::Reset( aReason );
+    TOOL_BASE::Reset( aReason );
 }
 
 
@@ -259,6 +261,7 @@ void LENGTH_TUNER_TOOL::setTransitions()
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneSingleTrace.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPair.MakeEvent() );
     Go( &LENGTH_TUNER_TOOL::MainLoop, PCB_ACTIONS::routerTuneDiffPairSkew.MakeEvent() );
+    Go( &LENGTH_TUNER_TOOL::TuneSelectedNets, PCB_ACTIONS::routerTuneSelectedNets.MakeEvent() );
 }
 
 
@@ -332,3 +335,65 @@ int LENGTH_TUNER_TOOL::meanderSettingsDialog( const TOOL_EVENT& aEvent )
 
     return 0;
 }
+
+
+int LENGTH_TUNER_TOOL::TuneSelectedNets( const TOOL_EVENT& aEvent )
+{
+    const auto&      selection = m_toolMgr->GetTool<SELECTION_TOOL>()->GetSelection();
+    PNS::ROUTER_MODE mode = aEvent.Parameter<PNS::ROUTER_MODE>();
+    std::vector<int> nets;
+
+    // Tune the nets in the order they were selected
+    for( EDA_ITEM* item : selection )
+    {
+        if( item->Type() != PCB_TRACE_T && item->Type() != PCB_VIA_T )
+            continue;
+
+        int net = static_cast<BOARD_CONNECTED_ITEM*>( item )->GetNetCode();
+
+        if( net > 0 && std::find( nets.begin(), nets.end(), net ) == nets.end() )
+            nets.push_back( net );
+    }
+
+    if( nets.empty() )
+    {
+        DisplayError( frame(), _( "Please select the tracks of the nets you want to tune." ) );
+        return 0;
+    }
+
+    PNS::MEANDER_SETTINGS             settings = m_savedMeanderSettings;
+    DIALOG_PNS_LENGTH_TUNING_SETTINGS settingsDlg( frame(), settings, mode );
+
+    if( settingsDlg.ShowModal() != wxID_OK )
+        return 0;
+
+    m_savedMeanderSettings = settings;
+
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+    m_router->UpdateWorld();
+
+    PNS::MEANDER_BATCH batch( m_router );
+
+    for( int net : nets )
+        batch.AddJob( net, mode, settings );
+
+    batch.Run();
+
+    wxString untuned;
+
+    for( const PNS::MEANDER_BATCH::JOB& job : batch.Jobs() )
+    {
+        if( job.m_done && job.m_status == PNS::MEANDER_PLACER_BASE::TUNED )
+            continue;
+
+        NETINFO_ITEM* netinfo = board()->FindNet( job.m_net );
+
+        untuned += wxString::Format( "\n%s", netinfo ? netinfo->GetNetname() : wxString( "?" ) );
+    }
+
+    if( !untuned.IsEmpty() )
+        DisplayInfoMessage( frame(), _( "Some nets could not be tuned to the target length." ),
+                            _( "Nets not tuned:" ) + untuned );
+
+    return 0;
+}
@@ -38,6 +38,9 @@ public:
 
     int MainLoop( const TOOL_EVENT& aEvent );
 
+    ///> Tunes the nets of the selected tracks with PNS::MEANDER_BATCH
+    int TuneSelectedNets( const TOOL_EVENT& aEvent );
+
     void setTransitions() override;
 
 private:
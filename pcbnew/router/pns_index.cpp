@@ -26,6 +26,8 @@ namespace PNS {
 INDEX::INDEX()
 {
     memset( m_subIndices, 0, sizeof( m_subIndices ) );
+    memset( m_packedSubIndices, 0, sizeof( m_packedSubIndices ) );
+    m_bulkLoading = false;
 }
 
 
@@ -35,7 +37,7 @@ INDEX::~INDEX()
 }
 
 
-INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
+int INDEX::subindexNumber( const ITEM* aItem ) const
 {
     int idx_n = -1;
 
@@ -73,23 +75,89 @@ INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
     {
         wxASSERT( idx_n >= 0 );
         wxASSERT( idx_n < MaxSubIndices );
-        return nullptr;
+        return -1;
     }
 
+    return idx_n;
+}
+
+
+INDEX::ITEM_SHAPE_INDEX* INDEX::getSubindex( const ITEM* aItem )
+{
+    int idx_n = subindexNumber( aItem );
+
+    if( idx_n < 0 )
+        return nullptr;
+
     if( !m_subIndices[idx_n] )
         m_subIndices[idx_n] = new ITEM_SHAPE_INDEX;
 
     return m_subIndices[idx_n];
 }
 
+
+void INDEX::BeginBulkLoad()
+{
+    m_bulkLoading = true;
+}
+
+
+void INDEX::EndBulkLoad()
+{
+    m_bulkLoading = false;
+    m_packedItems.clear();
+
+    for( int i = 0; i < MaxSubIndices; ++i )
+    {
+        ITEM_PACKED_INDEX* idx = m_packedSubIndices[i];
+
+        if( !idx )
+            continue;
+
+        idx->Build();
+
+        for( size_t entry = 0; entry < idx->Size(); entry++ )
+            m_packedItems[ idx->Item( entry ) ] = entry;
+    }
+}
+
+
+void INDEX::repack( int aSubindex )
+{
+    ITEM_PACKED_INDEX* idx = m_packedSubIndices[aSubindex];
+
+    // the entries are renumbered by the rebuild
+    idx->Build();
+
+    for( size_t entry = 0; entry < idx->Size(); entry++ )
+        m_packedItems[ idx->Item( entry ) ] = entry;
+}
+
+
 void INDEX::Add( ITEM* aItem )
 {
-    ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
+    if( m_bulkLoading )
+    {
+        int idx_n = subindexNumber( aItem );
+
+        if( idx_n < 0 )
+            return;
+
+        if( !m_packedSubIndices[idx_n] )
+            m_packedSubIndices[idx_n] = new ITEM_PACKED_INDEX;
+
+        m_packedItems[aItem] = m_packedSubIndices[idx_n]->Add( aItem->Shape()->BBox(), aItem );
+    }
+    else
+    {
+        ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
 
-    if( !idx )
-        return;
+        if( !idx )
+            return;
+
+        idx->Add( aItem );
+    }
 
-    idx->Add( aItem );
     m_allItems.insert( aItem );
     int net = aItem->Net();
 
@@ -101,12 +169,32 @@ void INDEX::Add( ITEM* aItem )
 
 void INDEX::Remove( ITEM* aItem )
 {
-    ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
+    auto packed = m_packedItems.find( aItem );
+
+    if( packed != m_packedItems.end() )
+    {
+        int                idx_n = subindexNumber( aItem );
+        ITEM_PACKED_INDEX* idx = m_packedSubIndices[idx_n];
+
+        idx->Remove( packed->second );
+        m_packedItems.erase( packed );
+
+        // masked entries still cost every search that reaches them: drop them once there
+        // are enough (not while bulk loading, as EndBulkLoad() rebuilds everything anyway)
+        if( !m_bulkLoading
+                && idx->RemovedCount() * 100 > idx->Size() * PackedRebuildThreshold )
+            repack( idx_n );
+    }
+    else
+    {
+        ITEM_SHAPE_INDEX* idx = getSubindex( aItem );
+
+        if( !idx )
+            return;
 
-    if( !idx )
-        return;
+        idx->Remove( aItem );
+    }
 
-    idx->Remove( aItem );
     m_allItems.erase( aItem );
     int net = aItem->Net();
 
@@ -131,7 +219,12 @@ void INDEX::Clear()
             delete idx;
 
         m_subIndices[i] = NULL;
+
+        delete m_packedSubIndices[i];
+        m_packedSubIndices[i] = NULL;
     }
+
+    m_packedItems.clear();
 }
 
 
@@ -24,11 +24,13 @@
 
 #include <layers_id_colors_and_visibility.h>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <boost/range/adaptor/map.hpp>
 
 #include <list>
+#include <geometry/packed_rtree.h>
 #include <geometry/shape_index.h>
 
 #include "pns_item.h"
@@ -42,12 +44,18 @@ namespace PNS {
  * Custom spatial index, holding our board items and allowing for very fast searches. Items
  * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
  * overlap and improving search time.
+ *
+ * Items added between BeginBulkLoad() and EndBulkLoad() (typically the board items copied by
+ * SyncWorld()) go to packed, static R-trees, which are much faster to build and to search.
+ * Items added later go to the dynamic R-trees. Items removed from a packed R-tree are only
+ * masked, until they make up a quarter of its entries and the tree gets packed again.
  **/
 class INDEX
 {
 public:
     typedef std::list<ITEM*>            NET_ITEMS_LIST;
     typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
+    typedef PACKED_RTREE<ITEM*>         ITEM_PACKED_INDEX;
     typedef std::unordered_set<ITEM*>   ITEM_SET;
 
     INDEX();
@@ -60,6 +68,21 @@ public:
      */
     void Add( ITEM* aItem );
 
+    /**
+     * Function BeginBulkLoad()
+     *
+     * Items added from now on go to the packed subindices, which are built by EndBulkLoad().
+     * Searches still find them in the meantime, although slowly.
+     */
+    void BeginBulkLoad();
+
+    /**
+     * Function EndBulkLoad()
+     *
+     * Builds the packed subindices.
+     */
+    void EndBulkLoad();
+
     /**
      * Function Remove()
      *
@@ -149,12 +172,23 @@ private:
     static const int    SI_PadsTop      = 0;
     static const int    SI_PadsBottom   = 1;
 
+    ///> share of removed entries (in percent) above which a packed subindex is rebuilt
+    static const int    PackedRebuildThreshold = 25;
+
     template <class Visitor>
     int querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor );
 
+    int subindexNumber( const ITEM* aItem ) const;
     ITEM_SHAPE_INDEX* getSubindex( const ITEM* aItem );
+    void repack( int aSubindex );
 
     ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
+    ITEM_PACKED_INDEX* m_packedSubIndices[MaxSubIndices];
+
+    ///> entry of each live item of the packed subindices
+    std::unordered_map<ITEM*, size_t> m_packedItems;
+    bool m_bulkLoading;
+
     std::map<int, NET_ITEMS_LIST> m_netMap;
     ITEM_SET m_allItems;
 };
@@ -163,10 +197,20 @@ private:
 template<class Visitor>
 int INDEX::querySingle( int index, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor )
 {
-    if( !m_subIndices[index] )
-        return 0;
+    int total = 0;
+
+    if( m_packedSubIndices[index] )
+    {
+        BOX2I box = aShape->BBox();
+        box.Inflate( aMinDistance );
 
-    return m_subIndices[index]->Query( aShape, aMinDistance, aVisitor, false );
+        total += m_packedSubIndices[index]->Search( box, aVisitor );
+    }
+
+    if( m_subIndices[index] )
+        total += m_subIndices[index]->Query( aShape, aMinDistance, aVisitor, false );
+
+    return total;
 }
 
 template<class Visitor>
@@ -22,6 +22,7 @@
 #include "pns_node.h"
 #include "pns_item.h"
 #include "pns_line.h"
+#include "pns_segment.h"
 
 typedef VECTOR2I::extended_type ecoord;
 
@@ -38,6 +39,28 @@ bool ITEM::collideSimple( const ITEM* aOther, int aClearance, bool aNeedMTV, VEC
     if( !m_layers.Overlaps( aOther->m_layers ) )
         return false;
 
+    // Traces against traces are the bulk of the router collision checks: test the line chains
+    // directly with the batched segment kernels (these cases never compute a MTV anyway)
+    if( m_kind == LINE_T && aOther->m_kind == LINE_T )
+    {
+        return static_cast<const LINE*>( this )->CLine().Collide(
+                static_cast<const LINE*>( aOther )->CLine(), aClearance );
+    }
+    else if( m_kind == LINE_T && aOther->m_kind == SEGMENT_T )
+    {
+        const SEGMENT* seg = static_cast<const SEGMENT*>( aOther );
+
+        return static_cast<const LINE*>( this )->CLine().Collide(
+                seg->Seg(), aClearance + seg->Width() / 2 );
+    }
+    else if( m_kind == SEGMENT_T && aOther->m_kind == LINE_T )
+    {
+        const SEGMENT* seg = static_cast<const SEGMENT*>( this );
+
+        return static_cast<const LINE*>( aOther )->CLine().Collide(
+                seg->Seg(), aClearance + seg->Width() / 2 );
+    }
+
     if( aNeedMTV )
         return Shape()->Collide( aOther->Shape(), aClearance, *aMTV );
     else
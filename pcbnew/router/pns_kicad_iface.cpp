@@ -21,6 +21,7 @@
 
 #include <undo_redo_container.h>
 #include <class_board.h>
+#include <class_module.h>
 #include <board_connected_item.h>
 #include <class_text_mod.h>
 #include <class_edge_mod.h>
@@ -32,6 +33,7 @@
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/convex_hull.h>
 #include <confirm.h>
+#include <profile.h>
 
 #include <view/view.h>
 #include <view/view_item.h>
@@ -533,6 +535,9 @@ PNS_KICAD_IFACE::PNS_KICAD_IFACE()
     m_router = nullptr;
     m_debugDecorator = nullptr;
     m_dispOptions = nullptr;
+    m_syncedItem = nullptr;
+    m_syncedBoard = nullptr;
+    m_syncedSerial = 0;
 }
 
 
@@ -897,7 +902,7 @@ bool PNS_KICAD_IFACE::syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone )
                 solid->SetShape( triShape );
                 solid->SetRoutable( false );
 
-                aWorld->Add( std::move( solid ) );
+                addToWorld( aWorld, std::move( solid ) );
             }
         }
     }
@@ -931,7 +936,7 @@ bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYE
         solid->SetShape( new SHAPE_SEGMENT( start, end, textWidth ) );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addToWorld( aWorld, std::move( solid ) );
     }
 
     return true;
@@ -1045,7 +1050,7 @@ bool PNS_KICAD_IFACE::syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem )
         solid->SetShape( seg );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addToWorld( aWorld, std::move( solid ) );
     }
 
     return true;
@@ -1114,78 +1119,175 @@ bool PNS_KICAD_IFACE::IsItemVisible( const PNS::ITEM* aItem )
 
 void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
 {
-    int worstPadClearance = 0;
-
     if( !m_board )
     {
         wxLogTrace( "PNS", "No board attached, aborting sync." );
         return;
     }
 
+    m_worldItems.clear();
+
     for( auto gitem : m_board->Drawings() )
-    {
-        if ( gitem->Type() == PCB_LINE_T )
-        {
-            syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( gitem ) );
-        }
-        else if( gitem->Type() == PCB_TEXT_T )
-        {
-            syncTextItem( aWorld, static_cast<TEXTE_PCB*>( gitem ), gitem->GetLayer() );
-        }
-    }
+        syncItem( aWorld, gitem );
 
     for( auto zone : m_board->Zones() )
+        syncItem( aWorld, zone );
+
+    for( auto module : m_board->Modules() )
+        syncItem( aWorld, module );
+
+    for( auto t : m_board->Tracks() )
+        syncItem( aWorld, t );
+
+    syncRules( aWorld );
+
+    m_syncedBoard = m_board;
+    m_syncedSerial = m_board->ChangeLog().Serial();
+}
+
+
+bool PNS_KICAD_IFACE::UpdateWorld( PNS::NODE* aWorld )
+{
+    std::vector<BOARD_CHANGE_LOG::CHANGE> changes;
+
+    if( !m_board || m_board != m_syncedBoard
+            || !m_board->ChangeLog().ChangesSince( m_syncedSerial, changes ) )
+        return false;
+
+    PROF_COUNTER cnt( "pns-update-world" );
+
+    // Items removed later in the log may have been freed already: they are only looked up
+    std::unordered_map<const BOARD_ITEM*, size_t> lastRemoval;
+
+    for( size_t i = 0; i < changes.size(); i++ )
     {
-        syncZone( aWorld, zone );
+        if( changes[i].m_type == BOARD_CHANGE_LOG::REMOVED )
+            lastRemoval[ changes[i].m_item ] = i;
     }
 
-    for( auto module : m_board->Modules() )
+    for( size_t i = 0; i < changes.size(); i++ )
     {
-        for( auto pad : module->Pads() )
+        BOARD_ITEM* item = changes[i].m_item;
+        auto        removal = lastRemoval.find( item );
+        bool        removedLater = removal != lastRemoval.end() && removal->second > i;
+
+        switch( changes[i].m_type )
         {
-            if( auto solid = syncPad( pad ) )
-                aWorld->Add( std::move( solid ) );
+        case BOARD_CHANGE_LOG::ADDED:
+            // The items committed by the router are in the world already
+            if( !removedLater && !m_worldItems.count( item ) )
+                syncItem( aWorld, item );
 
-            worstPadClearance = std::max( worstPadClearance, pad->GetLocalClearance() );
-        }
+            break;
 
-        syncTextItem( aWorld, &module->Reference(), module->Reference().GetLayer() );
-        syncTextItem( aWorld, &module->Value(), module->Value().GetLayer() );
+        case BOARD_CHANGE_LOG::REMOVED:
+            removeFromWorld( aWorld, item );
+            break;
 
-        for( MODULE_ZONE_CONTAINER* zone : module->Zones() )
-            syncZone( aWorld, zone );
+        case BOARD_CHANGE_LOG::MODIFIED:
+            removeFromWorld( aWorld, item );
 
-        if( module->IsNetTie() )
-            continue;
+            if( !removedLater )
+                syncItem( aWorld, item );
 
-        for( auto mgitem : module->GraphicalItems() )
-        {
-            if( mgitem->Type() == PCB_MODULE_EDGE_T )
-            {
-                syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( mgitem ) );
-            }
-            else if( mgitem->Type() == PCB_MODULE_TEXT_T )
-            {
-                syncTextItem( aWorld, dynamic_cast<TEXTE_MODULE*>( mgitem ), mgitem->GetLayer() );
-            }
+            break;
         }
     }
 
-    for( auto t : m_board->Tracks() )
+    syncRules( aWorld );
+
+    m_syncedSerial = m_board->ChangeLog().Serial();
+
+    cnt.Stop();
+    wxLogTrace( "PNS", "UpdateWorld: %d board changes applied in %.1f ms", (int) changes.size(),
+                cnt.msecs() );
+
+    return true;
+}
+
+
+void PNS_KICAD_IFACE::syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem )
+{
+    m_syncedItem = aItem;
+
+    switch( aItem->Type() )
     {
-        KICAD_T type = t->Type();
+    case PCB_LINE_T:
+        syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( aItem ) );
+        break;
+
+    case PCB_TEXT_T:
+        syncTextItem( aWorld, static_cast<TEXTE_PCB*>( aItem ), aItem->GetLayer() );
+        break;
+
+    case PCB_ZONE_AREA_T:
+        syncZone( aWorld, static_cast<ZONE_CONTAINER*>( aItem ) );
+        break;
+
+    case PCB_MODULE_T:
+        syncModule( aWorld, static_cast<MODULE*>( aItem ) );
+        break;
+
+    case PCB_TRACE_T:
+        if( auto segment = syncTrack( static_cast<TRACK*>( aItem ) ) )
+            addToWorld( aWorld, std::move( segment ) );
+
+        break;
 
-        if( type == PCB_TRACE_T )
+    case PCB_VIA_T:
+        if( auto via = syncVia( static_cast<VIA*>( aItem ) ) )
+            addToWorld( aWorld, std::move( via ) );
+
+        break;
+
+    default:
+        break;
+    }
+
+    m_syncedItem = nullptr;
+}
+
+
+void PNS_KICAD_IFACE::syncModule( PNS::NODE* aWorld, MODULE* aModule )
+{
+    for( auto pad : aModule->Pads() )
+    {
+        if( auto solid = syncPad( pad ) )
+            addToWorld( aWorld, std::move( solid ) );
+    }
+
+    syncTextItem( aWorld, &aModule->Reference(), aModule->Reference().GetLayer() );
+    syncTextItem( aWorld, &aModule->Value(), aModule->Value().GetLayer() );
+
+    for( MODULE_ZONE_CONTAINER* zone : aModule->Zones() )
+        syncZone( aWorld, zone );
+
+    if( aModule->IsNetTie() )
+        return;
+
+    for( auto mgitem : aModule->GraphicalItems() )
+    {
+        if( mgitem->Type() == PCB_MODULE_EDGE_T )
         {
-            if( auto segment = syncTrack( t ) )
-                aWorld->Add( std::move( segment ) );
+            syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( mgitem ) );
         }
-        else if( type == PCB_VIA_T )
+        else if( mgitem->Type() == PCB_MODULE_TEXT_T )
         {
-            if( auto via = syncVia( static_cast<VIA*>( t ) ) )
-                aWorld->Add( std::move( via ) );
+            syncTextItem( aWorld, dynamic_cast<TEXTE_MODULE*>( mgitem ), mgitem->GetLayer() );
         }
     }
+}
+
+
+void PNS_KICAD_IFACE::syncRules( PNS::NODE* aWorld )
+{
+    int worstPadClearance = 0;
+
+    for( auto module : m_board->Modules() )
+    {
+        for( auto pad : module->Pads() )
+            worstPadClearance = std::max( worstPadClearance, pad->GetLocalClearance() );
+    }
 
     int worstRuleClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
 
@@ -1197,6 +1299,34 @@ void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
 }
 
 
+template <class T>
+void PNS_KICAD_IFACE::addToWorld( PNS::NODE* aWorld, std::unique_ptr<T> aItem )
+{
+    PNS::ITEM* item = aItem.get();
+
+    aWorld->Add( std::move( aItem ) );
+
+    // Degenerate and redundant segments are not added
+    if( aWorld->HasItem( item ) )
+        m_worldItems.emplace( m_syncedItem, item );
+}
+
+
+void PNS_KICAD_IFACE::removeFromWorld( PNS::NODE* aWorld, const BOARD_ITEM* aItem )
+{
+    auto range = m_worldItems.equal_range( aItem );
+
+    for( auto it = range.first; it != range.second; ++it )
+    {
+        // Skip the items the router has removed meanwhile
+        if( aWorld->HasItem( it->second ) )
+            aWorld->Remove( it->second );
+    }
+
+    m_worldItems.erase( aItem );
+}
+
+
 void PNS_KICAD_IFACE::EraseView()
 {
     for( auto item : m_hiddenItems )
@@ -1280,11 +1410,12 @@ void PNS_KICAD_IFACE::RemoveItem( PNS::ITEM* aItem )
     if( parent )
     {
         m_commit->Remove( parent );
+        m_worldItems.erase( parent );
     }
 }
 
 
-void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
+BOARD_CONNECTED_ITEM* PNS_KICAD_IFACE::createBoardItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* newBI = NULL;
 
@@ -1325,10 +1456,23 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 
     if( newBI )
     {
-        newBI->SetLocalRatsnestVisible( m_dispOptions->m_ShowGlobalRatsnest );
         aItem->SetParent( newBI );
         newBI->ClearFlags();
 
+        m_worldItems.emplace( newBI, aItem );
+    }
+
+    return newBI;
+}
+
+
+void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
+{
+    BOARD_CONNECTED_ITEM* newBI = createBoardItem( aItem );
+
+    if( newBI )
+    {
+        newBI->SetLocalRatsnestVisible( m_dispOptions->m_ShowGlobalRatsnest );
         m_commit->Add( newBI );
     }
 }
@@ -22,6 +22,8 @@
 #ifndef __PNS_KICAD_IFACE_H
 #define __PNS_KICAD_IFACE_H
 
+#include <cstdint>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "pns_router.h"
@@ -31,6 +33,8 @@ class PNS_PCBNEW_DEBUG_DECORATOR;
 
 class BOARD;
 class BOARD_COMMIT;
+class BOARD_ITEM;
+class MODULE;
 class PCB_DISPLAY_OPTIONS;
 class PCB_TOOL_BASE;
 
@@ -51,6 +55,7 @@ public:
     void SetBoard( BOARD* aBoard );
     void SetView( KIGFX::VIEW* aView );
     void SyncWorld( PNS::NODE* aWorld ) override;
+    bool UpdateWorld( PNS::NODE* aWorld ) override;
     void EraseView() override;
     bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) override;
     bool IsItemVisible( const PNS::ITEM* aItem ) override;
@@ -65,10 +70,22 @@ public:
     PNS::RULE_RESOLVER* GetRuleResolver() override;
     PNS::DEBUG_DECORATOR* GetDebugDecorator() override;
 
+protected:
+    ///> Creates the board item of a track or via added by the router, so that UpdateWorld()
+    ///> does not add it to the world again once it is committed.
+    BOARD_CONNECTED_ITEM* createBoardItem( PNS::ITEM* aItem );
+
 private:
     PNS_PCBNEW_RULE_RESOLVER* m_ruleResolver;
     PNS_PCBNEW_DEBUG_DECORATOR* m_debugDecorator;
 
+    void syncItem( PNS::NODE* aWorld, BOARD_ITEM* aItem );
+    void syncModule( PNS::NODE* aWorld, MODULE* aModule );
+    void syncRules( PNS::NODE* aWorld );
+    template <class T>
+    void addToWorld( PNS::NODE* aWorld, std::unique_ptr<T> aItem );
+    void removeFromWorld( PNS::NODE* aWorld, const BOARD_ITEM* aItem );
+
     std::unique_ptr<PNS::SOLID> syncPad( D_PAD* aPad );
     std::unique_ptr<PNS::SEGMENT> syncTrack( TRACK* aTrack );
     std::unique_ptr<PNS::VIA> syncVia( VIA* aVia );
@@ -85,6 +102,16 @@ private:
     PCB_TOOL_BASE* m_tool;
     std::unique_ptr<BOARD_COMMIT> m_commit;
     const PCB_DISPLAY_OPTIONS* m_dispOptions;
+
+    ///> world items made from each board item, for UpdateWorld()
+    std::unordered_multimap<const BOARD_ITEM*, PNS::ITEM*> m_worldItems;
+
+    ///> board item being synced
+    const BOARD_ITEM* m_syncedItem;
+
+    ///> board and change log serial the world is up to date with
+    const BOARD* m_syncedBoard;
+    uint64_t m_syncedSerial;
 };
 
 #endif
@@ -385,6 +385,13 @@ bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
     walkaround.SetDebugDecorator( Dbg() );
     walkaround.SetIterationLimit( Settings().WalkaroundIterationLimit() );
 
+    // The deadline comes with the parallel candidates, the serial walkaround is unchanged.
+    if( Settings().ParallelCandidates() )
+    {
+        walkaround.SetTimeLimit( Settings().WalkaroundTimeLimit() );
+        walkaround.SetParallel( true );
+    }
+
     WALKAROUND::WALKAROUND_STATUS wf = walkaround.Route( initTrack, walkFull, false );
 
     switch( Settings().OptimizerEffort() )
@@ -412,7 +419,18 @@ bool LINE_PLACER::rhWalkOnly( const VECTOR2I& aP, LINE& aNewHead )
         walkFull.AppendVia( makeVia( walkFull.CPoint( -1 ) ) );
     }
 
-    OPTIMIZER::Optimize( &walkFull, effort, m_currentNode );
+    OPTIMIZER optimizer( m_currentNode );
+
+    optimizer.SetEffortLevel( effort );
+    optimizer.SetCollisionMask( -1 );
+
+    if( Settings().ParallelCandidates() )
+    {
+        optimizer.SetTimeLimit( Settings().WalkaroundTimeLimit() );
+        optimizer.SetParallel( true );
+    }
+
+    optimizer.Optimize( &walkFull );
 
     if( m_currentNode->CheckColliding( &walkFull ) )
     {
@@ -586,10 +604,12 @@ bool LINE_PLACER::rhShoveOnly( const VECTOR2I& aP, LINE& aNewHead )
     walkaround.SetSolidsOnly( true );
     walkaround.SetIterationLimit( 10 );
     walkaround.SetDebugDecorator( Dbg() );
+    walkaround.SetParallel( Settings().ParallelCandidates() );
     WALKAROUND::WALKAROUND_STATUS stat_solids = walkaround.Route( initTrack, walkSolids );
 
     optimizer.SetEffortLevel( OPTIMIZER::MERGE_SEGMENTS );
     optimizer.SetCollisionMask( ITEM::SOLID_T );
+    optimizer.SetParallel( Settings().ParallelCandidates() );
     optimizer.Optimize( &walkSolids );
 
     if( stat_solids == WALKAROUND::DONE )
@@ -139,6 +139,12 @@ void LOGGER::Log( const VECTOR2I& aStart, const VECTOR2I& aEnd,
 }
 
 
+void LOGGER::LogEvent( const std::string& aName, const VECTOR2I& aP, int aArg )
+{
+    m_theLog << "event " << aName << " " << aP.x << " " << aP.y << " " << aArg << std::endl;
+}
+
+
 void LOGGER::dumpShape( const SHAPE* aSh )
 {
     switch( aSh->Type() )
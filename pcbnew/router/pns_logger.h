@@ -53,6 +53,13 @@ public:
     void Log( const VECTOR2I& aStart, const VECTOR2I& aEnd, int aKind = 0,
               const std::string& aName = std::string() );
 
+    /**
+     * Log a router input event (mode change, start, move or fix), as a line
+     * "event <name> <x> <y> <arg>" which can be replayed by the router benchmark
+     * of qa_pcbnew_tools.
+     */
+    void LogEvent( const std::string& aName, const VECTOR2I& aP, int aArg = 0 );
+
 private:
     void dumpShape( const SHAPE* aSh );
 
@@ -0,0 +1,380 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <profile.h>
+
+#include "pns_debug_decorator.h"
+#include "pns_diff_pair.h"
+#include "pns_dp_meander_placer.h"
+#include "pns_itemset.h"
+#include "pns_meander_batch.h"
+#include "pns_meander_placer.h"
+#include "pns_meander_skew_placer.h"
+#include "pns_node.h"
+#include "pns_segment.h"
+#include "pns_topology.h"
+
+namespace PNS {
+
+struct MEANDER_BATCH::TASK
+{
+    JOB*                                 m_job = nullptr;
+
+    ///> segment and points the placer is started and moved with
+    SEGMENT*                             m_startSeg = nullptr;
+    VECTOR2I                             m_start;
+    VECTOR2I                             m_end;
+
+    ///> traces being tuned, as found in the world, and their nets
+    std::vector<LINE>                    m_originals;
+    std::vector<int>                     m_nets;
+
+    ///> area the tuned traces may cover, including clearances
+    BOX2I                                m_area;
+
+    std::unique_ptr<MEANDER_PLACER_BASE> m_placer;
+
+    ///> the placers draw debug shapes; every task gets its own (no-op) decorator
+    DEBUG_DECORATOR                      m_dbg;
+};
+
+
+MEANDER_BATCH::MEANDER_BATCH( ROUTER* aRouter ) :
+    m_router( aRouter )
+{
+}
+
+
+MEANDER_BATCH::~MEANDER_BATCH()
+{
+}
+
+
+int MEANDER_BATCH::AddJob( int aNet, ROUTER_MODE aMode, const MEANDER_SETTINGS& aSettings )
+{
+    m_jobs.emplace_back( aNet, aMode, aSettings );
+
+    return (int) m_jobs.size() - 1;
+}
+
+
+/**
+ * Finds the longest trace of net aNet in aWorld.
+ * @return false if the net has no tracks
+ */
+static bool findLongestLine( NODE* aWorld, int aNet, LINE& aLine )
+{
+    std::set<ITEM*> items, visited;
+    long long int   longest = -1;
+
+    aWorld->AllItemsInNet( aNet, items );
+
+    for( ITEM* item : items )
+    {
+        if( !item->OfKind( ITEM::SEGMENT_T ) || visited.count( item ) )
+            continue;
+
+        LINE line = aWorld->AssembleLine( static_cast<SEGMENT*>( item ) );
+
+        for( SEGMENT* seg : line.LinkedSegments() )
+            visited.insert( seg );
+
+        if( line.CLine().Length() > longest )
+        {
+            longest = line.CLine().Length();
+            aLine = line;
+        }
+    }
+
+    return longest >= 0 && aLine.LinkCount() > 0;
+}
+
+
+bool MEANDER_BATCH::prepare( TASK& aTask )
+{
+    NODE*             world = m_router->GetWorld();
+    const JOB&        job = *aTask.m_job;
+    LINE              line;
+
+    if( !findLongestLine( world, job.m_net, line ) )
+        return false;
+
+    int extra = job.m_settings.m_maxAmplitude + job.m_settings.m_spacing;
+
+    if( job.m_mode == PNS_MODE_TUNE_SINGLE )
+    {
+        aTask.m_originals.push_back( line );
+        aTask.m_nets.push_back( line.Net() );
+        extra += 2 * line.Width();
+    }
+    else
+    {
+        TOPOLOGY  topo( world );
+        DIFF_PAIR pair;
+
+        if( !topo.AssembleDiffPair( line.GetLink( 0 ), pair ) )
+            return false;
+
+        if( !pair.PLine().LinkCount() || !pair.NLine().LinkCount() )
+            return false;
+
+        int gap = pair.Gap() < 0 ? m_router->Sizes().DiffPairGap() : pair.Gap();
+
+        aTask.m_originals.push_back( pair.PLine() );
+        aTask.m_originals.push_back( pair.NLine() );
+        aTask.m_nets.push_back( pair.NetP() );
+        aTask.m_nets.push_back( pair.NetN() );
+        extra += 2 * pair.Width() + gap;
+    }
+
+    const LINE& base = aTask.m_originals[0];
+
+    aTask.m_startSeg = base.GetLink( 0 );
+    aTask.m_start = base.CPoint( 0 );
+    aTask.m_end = base.CPoint( -1 );
+
+    aTask.m_area = base.CLine().BBox();
+
+    for( const LINE& orig : aTask.m_originals )
+        aTask.m_area.Merge( orig.CLine().BBox() );
+
+    aTask.m_area.Inflate( extra + world->GetMaxClearance() );
+
+    return true;
+}
+
+
+void MEANDER_BATCH::splitWave( std::vector<TASK>& aTasks, std::vector<TASK*>& aWave,
+                               std::vector<JOB*>& aPending ) const
+{
+    // A task waits for every earlier task it may interact with
+    for( size_t i = 0; i < aTasks.size(); i++ )
+    {
+        bool blocked = false;
+
+        for( size_t j = 0; j < i && !blocked; j++ )
+            blocked = aTasks[i].m_area.Intersects( aTasks[j].m_area );
+
+        if( blocked )
+            aPending.push_back( aTasks[i].m_job );
+        else
+            aWave.push_back( &aTasks[i] );
+    }
+}
+
+
+int MEANDER_BATCH::runWave( std::vector<TASK*>& aWave )
+{
+    std::vector<TASK*> started;
+
+    // Starting a placer branches the world, which is not thread safe
+    for( TASK* task : aWave )
+    {
+        JOB& job = *task->m_job;
+
+        switch( job.m_mode )
+        {
+        case PNS_MODE_TUNE_SINGLE:
+            task->m_placer = std::make_unique<MEANDER_PLACER>( m_router );
+            break;
+        case PNS_MODE_TUNE_DIFF_PAIR:
+            task->m_placer = std::make_unique<DP_MEANDER_PLACER>( m_router );
+            break;
+        case PNS_MODE_TUNE_DIFF_PAIR_SKEW:
+            task->m_placer = std::make_unique<MEANDER_SKEW_PLACER>( m_router );
+            break;
+        default:
+            continue;
+        }
+
+        task->m_placer->UpdateSizes( m_router->Sizes() );
+        task->m_placer->SetLayer( task->m_startSeg->Layer() );
+        task->m_placer->SetDebugDecorator( &task->m_dbg );
+        task->m_placer->UpdateSettings( job.m_settings );
+
+        if( task->m_placer->Start( task->m_start, task->m_startSeg ) )
+            started.push_back( task );
+    }
+
+    // Tuning only branches the placer's own node and reads the world
+    std::atomic<size_t> nextItem( 0 );
+    size_t              parallelThreadCount =
+            std::min<size_t>( std::thread::hardware_concurrency(), started.size() );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto tune_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < started.size(); i = nextItem++ )
+        {
+            TASK* task = started[i];
+
+            if( task->m_placer->Move( task->m_end, nullptr ) )
+                task->m_job->m_done = true;
+
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        tune_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, tune_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    NODE* world = m_router->GetWorld();
+    NODE* batch = world->Branch();
+    int   changed = 0;
+
+    for( TASK* task : started )
+    {
+        JOB& job = *task->m_job;
+
+        if( !job.m_done )
+            continue;
+
+        job.m_status = task->m_placer->TuningStatus();
+
+        // Too long traces are left as they are, as the placer does not shorten them
+        if( job.m_status == MEANDER_PLACER_BASE::TOO_LONG )
+            continue;
+
+        ITEM_SET      traces = task->m_placer->Traces();
+        std::set<int> tunedNets;
+
+        for( ITEM* item : traces.Items() )
+            tunedNets.insert( item->Net() );
+
+        // The skew placer only tunes one line of the pair: the other one stays as it is
+        for( LINE& orig : task->m_originals )
+        {
+            if( tunedNets.count( orig.Net() ) )
+                batch->Remove( orig );
+        }
+
+        for( ITEM* item : traces.Items() )
+        {
+            if( LINE* l = dyn_cast<LINE*>( item ) )
+                batch->Add( *l );
+        }
+
+        changed++;
+    }
+
+    // The placers hold branches of the world that go away with the commit
+    for( TASK* task : aWave )
+        task->m_placer.reset();
+
+    m_router->StageRouting( batch );
+
+    return changed;
+}
+
+
+int MEANDER_BATCH::Run()
+{
+    PROF_COUNTER      timer;
+    std::vector<JOB*> pending;
+    std::set<int>     claimedNets;
+
+    // A net is tuned by the first job listing it.  The others (duplicates, or both nets of a
+    // differential pair) would remove traces added by the same board commit.
+    for( JOB& job : m_jobs )
+    {
+        TASK task;
+        task.m_job = &job;
+        job.m_done = false;
+
+        if( !prepare( task ) )
+            continue;
+
+        bool claimed = false;
+
+        for( int net : task.m_nets )
+            claimed |= claimedNets.count( net ) > 0;
+
+        if( claimed )
+        {
+            wxLogTrace( "PNS", "MEANDER_BATCH: net %d is already tuned by another job",
+                        job.m_net );
+            continue;
+        }
+
+        claimedNets.insert( task.m_nets.begin(), task.m_nets.end() );
+        pending.push_back( &job );
+    }
+
+    int waveCount = 0;
+    int changed = 0;
+
+    // The tasks refer to items of the world, and every wave commits the tuned traces to it.
+    // So the jobs left are prepared again against the world of the previous wave.
+    while( !pending.empty() )
+    {
+        std::vector<TASK>  tasks;
+        std::vector<TASK*> wave;
+
+        tasks.reserve( pending.size() );
+
+        for( JOB* job : pending )
+        {
+            TASK task;
+            task.m_job = job;
+
+            if( prepare( task ) )
+                tasks.push_back( std::move( task ) );
+        }
+
+        pending.clear();
+        splitWave( tasks, wave, pending );
+
+        if( wave.empty() )
+            break;
+
+        changed += runWave( wave );
+        waveCount++;
+    }
+
+    if( changed )
+        m_router->PushStagedRouting();
+
+    timer.Stop();
+
+    wxLogTrace( "PNS", "MEANDER_BATCH: %d jobs, %d waves, %d changed, %.1f ms",
+                (int) m_jobs.size(), waveCount, changed, timer.msecs() );
+
+    return changed;
+}
+
+}
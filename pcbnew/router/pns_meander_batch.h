@@ -0,0 +1,111 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_MEANDER_BATCH_H
+#define __PNS_MEANDER_BATCH_H
+
+#include <vector>
+
+#include "pns_meander.h"
+#include "pns_meander_placer_base.h"
+#include "pns_router.h"
+
+namespace PNS {
+
+/**
+ * Class MEANDER_BATCH
+ *
+ * Non-interactive length tuning of a list of nets and differential pairs. Every job tunes
+ * the whole of the longest trace of its net with the meander placer of its mode. Jobs whose
+ * tuning areas do not overlap are tuned in parallel against the same world; the others wait
+ * for the jobs listed before them and look up their traces again in the world those left,
+ * so the outcome is the same as tuning the jobs one after another in the list order. A net
+ * is only tuned by the first job listing it: the later ones (duplicates, or the other net of
+ * a differential pair) are not done. All the tuned traces are pushed to the board as a
+ * single commit.
+ */
+class MEANDER_BATCH
+{
+public:
+    ///> A single net or differential pair to tune
+    struct JOB
+    {
+        JOB( int aNet, ROUTER_MODE aMode, const MEANDER_SETTINGS& aSettings ) :
+            m_net( aNet ),
+            m_mode( aMode ),
+            m_settings( aSettings ),
+            m_done( false ),
+            m_status( MEANDER_PLACER_BASE::TOO_SHORT )
+        {}
+
+        ///> net to tune (any of the two nets for differential pairs)
+        int m_net;
+
+        ///> PNS_MODE_TUNE_SINGLE, PNS_MODE_TUNE_DIFF_PAIR or PNS_MODE_TUNE_DIFF_PAIR_SKEW
+        ROUTER_MODE m_mode;
+
+        ///> meandering configuration, including the target length or skew
+        MEANDER_SETTINGS m_settings;
+
+        ///> true if the traces of the job were found and tuned
+        bool m_done;
+
+        ///> tuning status of the job, valid if m_done is set
+        MEANDER_PLACER_BASE::TUNING_STATUS m_status;
+    };
+
+    MEANDER_BATCH( ROUTER* aRouter );
+    ~MEANDER_BATCH();
+
+    /**
+     * Function AddJob()
+     *
+     * Adds a net or differential pair to the batch.
+     * @return the job index
+     */
+    int AddJob( int aNet, ROUTER_MODE aMode, const MEANDER_SETTINGS& aSettings );
+
+    /**
+     * Function Run()
+     *
+     * Tunes all the jobs and commits the results to the board.
+     * @return the number of jobs whose traces were changed.
+     */
+    int Run();
+
+    const std::vector<JOB>& Jobs() const
+    {
+        return m_jobs;
+    }
+
+private:
+    struct TASK;
+
+    bool prepare( TASK& aTask );
+    void splitWave( std::vector<TASK>& aTasks, std::vector<TASK*>& aWave,
+                    std::vector<JOB*>& aPending ) const;
+    int runWave( std::vector<TASK*>& aWave );
+
+    ROUTER*          m_router;
+    std::vector<JOB> m_jobs;
+};
+
+}
+
+#endif    // __PNS_MEANDER_BATCH_H
@@ -115,23 +115,38 @@ NODE* NODE::Branch()
     child->m_root = isRoot() ? this : m_root;
     child->m_maxClearance = m_maxClearance;
 
-    // Immmediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
-    if( !isRoot() )
-    {
-        JOINT_MAP::iterator j;
+    // The child starts empty: it only stores the items and joints changed in it, and
+    // reads the others from its parents (see QueryColliding() and FindJoint()).
+    return child;
+}
 
-        for( ITEM* item : *m_index )
-            child->m_index->Add( item );
 
-        child->m_joints = m_joints;
-        child->m_override = m_override;
+bool NODE::Overrides( ITEM* aItem ) const
+{
+    // The item is hidden if it was removed in any node between its owner and this one
+    for( const NODE* node = this; node && aItem->Owner() != node; node = node->m_parent )
+    {
+        if( !node->m_override.empty() && node->m_override.count( aItem ) )
+            return true;
     }
 
-    wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+    return false;
+}
 
-    return child;
+
+void NODE::overlayItems( ITEM_VECTOR& aItems ) const
+{
+    for( const NODE* node = this; node; node = node->m_parent )
+    {
+        if( node != this && node->isRoot() )
+            break;
+
+        for( ITEM* item : *node->m_index )
+        {
+            if( node == this || !Overrides( item ) )
+                aItems.push_back( item );
+        }
+    }
 }
 
 
@@ -255,14 +270,15 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
-    aVisitor.SetWorld( this, NULL );
-    m_index->Query( aItem, m_maxClearance, aVisitor );
-
-    // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() )
+    // look in the items added by this node, then in the ones of each parent up to the root,
+    // skipping the items removed on the way
+    for( NODE* node = this; node; node = node->m_parent )
     {
-        aVisitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, aVisitor );
+        if( !node->m_index->Size() )
+            continue;
+
+        aVisitor.SetWorld( node->isRoot() ? node : this, node == this ? NULL : this );
+        node->m_index->Query( aItem, m_maxClearance, aVisitor );
     }
 
     return 0;
@@ -279,22 +295,65 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles, int aK
 #endif
 
     visitor.SetCountLimit( aLimitCount );
-    visitor.SetWorld( this, NULL );
     visitor.m_forceClearance = aForceClearance;
-    // first, look for colliding items in the local index
-    m_index->Query( aItem, m_maxClearance, visitor );
 
-    // if we haven't found enough items, look in the root branch as well.
-    if( !isRoot() && ( visitor.m_matchCount < aLimitCount || aLimitCount < 0 ) )
+    // first, look for colliding items in the local index, then in the ones of the parents
+    // up to the root, as long as we haven't found enough items
+    for( NODE* node = this; node; node = node->m_parent )
     {
-        visitor.SetWorld( m_root, this );
-        m_root->m_index->Query( aItem, m_maxClearance, visitor );
+        if( node != this && aLimitCount >= 0 && visitor.m_matchCount >= aLimitCount )
+            break;
+
+        if( !node->m_index->Size() )
+            continue;
+
+        visitor.SetWorld( node->isRoot() ? node : this, node == this ? NULL : this );
+        node->m_index->Query( aItem, m_maxClearance, visitor );
     }
 
     return aObstacles.size();
 }
 
 
+const NODE::OBSTACLE_HULL& NODE::obstacleHull( const ITEM* aItem, int aClearance, int aWidth,
+                                               OBSTACLE_HULL& aStorage )
+{
+    // Only the items of the root live long enough to be worth caching, and they are only
+    // deleted after being removed from the root, which clears the cache.
+    if( !aItem->BelongsTo( m_root ) )
+    {
+        aStorage.m_hull = aItem->Hull( aClearance, aWidth );
+        aStorage.m_bbox = aStorage.m_hull.BBox();
+        return aStorage;
+    }
+
+    OBSTACLE_HULL_KEY key = { aItem, aClearance, aWidth };
+
+    std::lock_guard<std::mutex> lock( m_root->m_obstacleHullsLock );
+
+    auto cached = m_root->m_obstacleHulls.find( key );
+
+    if( cached != m_root->m_obstacleHulls.end() )
+        return cached->second;
+
+    OBSTACLE_HULL& hull = m_root->m_obstacleHulls[key];
+
+    hull.m_hull = aItem->Hull( aClearance, aWidth );
+    hull.m_bbox = hull.m_hull.BBox();
+
+    return hull;
+}
+
+
+void NODE::invalidateObstacleHulls()
+{
+    assert( isRoot() );
+
+    std::lock_guard<std::mutex> lock( m_obstacleHullsLock );
+    m_obstacleHulls.clear();
+}
+
+
 NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aItem, int aKindMask,
                                           const std::set<ITEM*>* aRestrictedSet )
 {
@@ -325,6 +384,9 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aItem, int aKindMask,
     nearest.m_item = NULL;
     nearest.m_distFirst = INT_MAX;
 
+    const BOX2I lineBBox = aLine.CLine().BBox();
+    OBSTACLE_HULL hullStorage;
+
     for( const OBSTACLE& obs : obs_list )
     {
         VECTOR2I ip_last;
@@ -337,7 +399,9 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aItem, int aKindMask,
 
         int clearance = GetClearance( obs.m_item, &aLine );
 
-        SHAPE_LINE_CHAIN hull = obs.m_item->Hull( clearance, aItem->Width() );
+        const OBSTACLE_HULL& obsHull = obstacleHull( obs.m_item, clearance, aItem->Width(),
+                                                     hullStorage );
+        const SHAPE_LINE_CHAIN& hull = obsHull.m_hull;
 
         if( aLine.EndsWithVia() )
         {
@@ -345,7 +409,8 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aItem, int aKindMask,
 
             SHAPE_LINE_CHAIN viaHull = aLine.Via().Hull( clearance, aItem->Width() );
 
-            viaHull.Intersect( hull, isect_list );
+            if( viaHull.BBox().Intersects( obsHull.m_bbox ) )
+                viaHull.Intersect( hull, isect_list );
 
             for( const SHAPE_LINE_CHAIN::INTERSECTION& isect : isect_list )
             {
@@ -371,7 +436,9 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aItem, int aKindMask,
 
         isect_list.clear();
 
-        hull.Intersect( aLine.CLine(), isect_list );
+        // The hull cannot cross the line if their bounding boxes do not overlap
+        if( lineBBox.Intersects( obsHull.m_bbox ) )
+            hull.Intersect( aLine.CLine(), isect_list );
 
         for( const SHAPE_LINE_CHAIN::INTERSECTION& isect : isect_list )
         {
@@ -508,14 +575,14 @@ const ITEM_SET NODE::HitTest( const VECTOR2I& aPoint ) const
 
     m_index->Query( &s, m_maxClearance, visitor );
 
-    if( !isRoot() )    // fixme: could be made cleaner
+    for( const NODE* node = m_parent; node; node = node->m_parent )    // fixme: could be made cleaner
     {
-        ITEM_SET items_root;
-        visitor.SetWorld( m_root, NULL );
-        HIT_VISITOR  visitor_root( items_root, aPoint );
-        m_root->m_index->Query( &s, m_maxClearance, visitor_root );
+        ITEM_SET items_parent;
+        HIT_VISITOR  visitor_parent( items_parent, aPoint );
+        visitor_parent.SetWorld( node, NULL );
+        node->m_index->Query( &s, m_maxClearance, visitor_parent );
 
-        for( ITEM* item : items_root.Items() )
+        for( ITEM* item : items_parent.Items() )
         {
             if( !Overrides( item ) )
                 items.Add( item );
@@ -621,16 +688,19 @@ void NODE::Add( std::unique_ptr< ITEM > aItem, bool aAllowRedundant )
 
 void NODE::doRemove( ITEM* aItem )
 {
-    // case 1: removing an item that is stored in the root node from any branch:
+    // case 1: removing an item that is stored in the root node or in a parent branch:
     // mark it as overridden, but do not remove
-    if( aItem->BelongsTo( m_root ) && !isRoot() )
+    if( !aItem->BelongsTo( this ) && !isRoot() )
         m_override.insert( aItem );
 
-    // case 2: the item belongs to this branch or a parent, non-root branch,
-    // or the root itself and we are the root: remove from the index
-    else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    // case 2: the item belongs to this branch, or we are the root: remove from the index
+    else
         m_index->Remove( aItem );
 
+    // the item may be deleted and its address reused: forget the hulls cached for it
+    if( isRoot() )
+        invalidateObstacleHulls();
+
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
     {
@@ -664,6 +734,8 @@ void NODE::removeViaIndex( VIA* aVia )
     tag.net = net;
     tag.pos = p;
 
+    copyParentJoints( tag );
+
     bool split;
     do
     {
@@ -686,6 +758,10 @@ void NODE::removeViaIndex( VIA* aVia )
         }
     } while( split );
 
+    // the parents still have the removed joints: do not look them up there any more
+    if( !isRoot() && m_joints.find( tag ) == m_joints.end() )
+        m_removedJoints.insert( tag );
+
     // and re-link them, using the former via's link list
     for(ITEM* item : links)
     {
@@ -958,17 +1034,13 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
+    NODE* node = findJointNode( tag );
 
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
-
-    if( f == end )
+    if( !node )
         return NULL;
 
+    JOINT_MAP::iterator f = node->m_joints.find( tag ), end = node->m_joints.end();
+
     while( f != end )
     {
         if( f->second.Layers().Overlaps( aLayer ) )
@@ -988,6 +1060,38 @@ void NODE::LockJoint( const VECTOR2I& aPos, const ITEM* aItem, bool aLock )
 }
 
 
+NODE* NODE::findJointNode( const JOINT::HASH_TAG& aTag )
+{
+    for( NODE* node = this; node; node = node->m_parent )
+    {
+        if( node->m_joints.find( aTag ) != node->m_joints.end() )
+            return node;
+
+        if( node->m_removedJoints.count( aTag ) )
+            return NULL;
+    }
+
+    return NULL;
+}
+
+
+void NODE::copyParentJoints( const JOINT::HASH_TAG& aTag )
+{
+    if( isRoot() || m_joints.find( aTag ) != m_joints.end() )
+        return;
+
+    NODE* node = findJointNode( aTag );
+
+    if( !node )
+        return;
+
+    std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = node->m_joints.equal_range( aTag );
+
+    for( JOINT_MAP::iterator f = range.first; f != range.second; ++f )
+        m_joints.insert( *f );
+}
+
+
 JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int aNet )
 {
     JOINT::HASH_TAG tag;
@@ -995,20 +1099,13 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
-    // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
+    // not found in this node and we are not root? find in the parents and copy results here.
+    copyParentJoints( tag );
+    m_removedJoints.erase( tag );
 
+    JOINT_MAP::iterator f;
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
-    {
-        range = m_root->m_joints.equal_range( tag );
-
-        for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
-    }
-
     // now insert and combine overlapping joints
     JOINT jt( aPos, aLayers, aNet );
 
@@ -1148,17 +1245,22 @@ void NODE::Dump( bool aLong )
 
 void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
 {
-    aRemoved.reserve( m_override.size() );
-    aAdded.reserve( m_index->Size() );
-
     if( isRoot() )
         return;
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
+    // the root items removed in this node or in one of its parents
+    std::unordered_set<ITEM*> removed;
+
+    for( NODE* node = this; !node->isRoot(); node = node->m_parent )
+    {
+        for( ITEM* item : node->m_override )
+        {
+            if( item->BelongsTo( m_root ) && removed.insert( item ).second )
+                aRemoved.push_back( item );
+        }
+    }
 
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-        aAdded.push_back( *i );
+    overlayItems( aAdded );
 }
 
 void NODE::releaseChildren()
@@ -1194,10 +1296,17 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
+        m_root->invalidateObstacleHulls();
+
+        ITEM_VECTOR removed;
+        ITEM_VECTOR added;
+
+        aNode->GetUpdatedItems( removed, added );
+
+        for( ITEM* item : removed )
             Remove( item );
 
-        for( auto i : *aNode->m_index )
+        for( ITEM* i : added )
         {
             i->SetRank( -1 );
             i->Unmark();
@@ -1216,6 +1325,18 @@ void NODE::KillChildren()
 }
 
 
+void NODE::BeginBulkLoad()
+{
+    m_index->BeginBulkLoad();
+}
+
+
+void NODE::EndBulkLoad()
+{
+    m_index->EndBulkLoad();
+}
+
+
 void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
 {
     INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aNet );
@@ -1226,12 +1347,12 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
             aItems.insert( item );
     }
 
-    if( !isRoot() )
+    for( NODE* node = m_parent; node; node = node->m_parent )
     {
-        INDEX::NET_ITEMS_LIST* l_root = m_root->m_index->GetItemsForNet( aNet );
+        INDEX::NET_ITEMS_LIST* l_parent = node->m_index->GetItemsForNet( aNet );
 
-        if( l_root )
-            for( INDEX::NET_ITEMS_LIST::iterator i = l_root->begin(); i!= l_root->end(); ++i )
+        if( l_parent )
+            for( INDEX::NET_ITEMS_LIST::iterator i = l_parent->begin(); i!= l_parent->end(); ++i )
                 if( !Overrides( *i ) )
                     aItems.insert( *i );
     }
@@ -1240,10 +1361,14 @@ void NODE::AllItemsInNet( int aNet, std::set<ITEM*>& aItems )
 
 void NODE::ClearRanks( int aMarkerMask )
 {
-    for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
+    ITEM_VECTOR items;
+
+    overlayItems( items );
+
+    for( ITEM* item : items )
     {
-        (*i)->SetRank( -1 );
-        (*i)->Mark( (*i)->Marker() & (~aMarkerMask) );
+        item->SetRank( -1 );
+        item->Mark( item->Marker() & (~aMarkerMask) );
     }
 }
 
@@ -1251,8 +1376,11 @@ void NODE::ClearRanks( int aMarkerMask )
 void NODE::RemoveByMarker( int aMarker )
 {
     std::list<ITEM*> garbage;
+    ITEM_VECTOR      items;
 
-    for( ITEM* item : *m_index )
+    overlayItems( items );
+
+    for( ITEM* item : items )
     {
         if( item->Marker() & aMarker )
             garbage.push_back( item );
@@ -1294,6 +1422,21 @@ SEGMENT* NODE::findRedundantSegment( SEGMENT* aSeg )
 }
 
 
+bool NODE::HasItem( ITEM* aItem ) const
+{
+    for( const NODE* node = this; node; node = node->m_parent )
+    {
+        if( node != this && node->isRoot() )
+            break;
+
+        if( node->m_index->Contains( aItem ) )
+            return node == this || !Overrides( aItem );
+    }
+
+    return false;
+}
+
+
 ITEM *NODE::FindItemByParent( const BOARD_CONNECTED_ITEM* aParent )
 {
     INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aParent->GetNetCode() );
@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <list>
+#include <mutex>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -118,7 +119,7 @@ protected:
     ///> node we are searching in (either root or a branch)
     const NODE* m_node;
 
-    ///> node that overrides root entries
+    ///> branch whose removed items must be skipped (NULL to accept all items)
     const NODE* m_override;
 
     ///> additional clearance
@@ -136,6 +137,10 @@ protected:
  * - assembly of lines connecting joints, finding loops and unique paths
  * - lightweight cloning/branching (for recursive optimization and shove
  * springback)
+ *
+ * A branch only stores its own changes (delta) with respect to its parent: the items added
+ * in it, the items of its parents removed in it and the joints it modified. Queries walk
+ * the chain of branches up to the root and skip the items removed on the way.
  **/
 class NODE
 {
@@ -173,7 +178,7 @@ public:
         return m_ruleResolver;
     }
 
-    ///> Returns the number of joints
+    ///> Returns the number of joints stored in this node (not in its parents)
     int JointCount() const
     {
         return m_joints.size();
@@ -321,8 +326,10 @@ public:
      * Function Branch()
      *
      * Creates a lightweight copy (called branch) of self that tracks
-     * the changes (added/removed items) wrs to the root. Note that if there are
-     * any branches in use, their parents must NOT be deleted.
+     * the changes (added/removed items) wrs to its parent. Note that if there are
+     * any branches in use, their parents must NOT be deleted, nor modified.
+     * The branch starts empty and reads the items and joints of its parents, so
+     * branching is O(1) and each branch only stores its own changes.
      * @return the new branch
      */
     NODE* Branch();
@@ -401,6 +408,17 @@ public:
     ///> Destroys all child nodes. Applicable only to the root node.
     void KillChildren();
 
+    /**
+     * Function BeginBulkLoad()
+     *
+     * Items added from now on are stored in packed spatial indices, built by EndBulkLoad().
+     * Meant for filling the root node with the board items.
+     */
+    void BeginBulkLoad();
+
+    ///> Builds the packed spatial indices of the items added since BeginBulkLoad().
+    void EndBulkLoad();
+
     void AllItemsInNet( int aNet, std::set<ITEM*>& aItems );
 
     void ClearRanks( int aMarkerMask = MK_HEAD | MK_VIOLATION );
@@ -409,17 +427,18 @@ public:
 
     ITEM* FindItemByParent( const BOARD_CONNECTED_ITEM* aParent );
 
+    ///> Returns true if aItem is visible in this node and was added by it or by one of
+    ///> its parents other than the root (by the root itself, for the root).
+    bool HasItem( ITEM* aItem ) const;
+
     bool HasChildren() const
     {
         return !m_children.empty();
     }
 
-    ///> checks if this branch contains an updated version of the m_item
-    ///> from the root branch.
-    bool Overrides( ITEM* aItem ) const
-    {
-        return m_override.find( aItem ) != m_override.end();
-    }
+    ///> checks if this branch, or one of its parents, removed the item aItem
+    ///> stored in a parent branch or in the root.
+    bool Overrides( ITEM* aItem ) const;
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
@@ -430,6 +449,63 @@ private:
     NODE( const NODE& aB );
     NODE& operator=( const NODE& aB );
 
+    ///> hull of an obstacle for a given clearance and walkaround thickness, and its
+    ///> bounding box
+    struct OBSTACLE_HULL
+    {
+        SHAPE_LINE_CHAIN m_hull;
+        BOX2I            m_bbox;
+    };
+
+    struct OBSTACLE_HULL_KEY
+    {
+        const ITEM* m_item;
+        int         m_clearance;
+        int         m_width;
+
+        bool operator==( const OBSTACLE_HULL_KEY& aOther ) const
+        {
+            return m_item == aOther.m_item && m_clearance == aOther.m_clearance
+                   && m_width == aOther.m_width;
+        }
+    };
+
+    struct OBSTACLE_HULL_KEY_HASH
+    {
+        std::size_t operator()( const OBSTACLE_HULL_KEY& aKey ) const
+        {
+            return std::hash<const void*>()( aKey.m_item )
+                   ^ ( std::hash<int>()( aKey.m_clearance ) * 31 )
+                   ^ ( std::hash<int>()( aKey.m_width ) * 131 );
+        }
+    };
+
+    typedef std::unordered_map<OBSTACLE_HULL_KEY, OBSTACLE_HULL, OBSTACLE_HULL_KEY_HASH>
+            OBSTACLE_HULL_CACHE;
+
+    /**
+     * Returns the hull of \a aItem for the given clearance and walkaround thickness.
+     * The hulls of the root items are cached in the root node until the root is modified;
+     * the hull of any other item is computed into \a aStorage.
+     */
+    const OBSTACLE_HULL& obstacleHull( const ITEM* aItem, int aClearance, int aWidth,
+                                       OBSTACLE_HULL& aStorage );
+
+    ///> forgets the cached hulls of the root items. Applicable only to the root node.
+    void invalidateObstacleHulls();
+
+    ///> returns the nearest node, from this one up to the root, which stores the joints
+    ///> of aTag, or NULL if there are none
+    NODE* findJointNode( const JOINT::HASH_TAG& aTag );
+
+    ///> copies here the joints of aTag from the nearest parent storing them, before
+    ///> they are modified in this branch
+    void copyParentJoints( const JOINT::HASH_TAG& aTag );
+
+    ///> appends the items of this node and of its parents except the root that are
+    ///> not removed in this node (all the items of the root, for the root)
+    void overlayItems( ITEM_VECTOR& aItems ) const;
+
     ///> tries to find matching joint and creates a new one if not found
     JOINT& touchJoint( const VECTOR2I&     aPos,
                        const LAYER_RANGE&  aLayers,
@@ -476,9 +552,14 @@ private:
                      bool        aStopAtLockedJoints );
 
     ///> hash table with the joints, linking the items. Joints are hashed by
-    ///> their position, layer set and net.
+    ///> their position, layer set and net.  A branch only stores the joints it
+    ///> modified; the others are looked up in its parents.
     JOINT_MAP m_joints;
 
+    ///> joints of the parents removed in this branch (they must not be looked up in the
+    ///> parents any more)
+    std::unordered_set<JOINT::HASH_TAG, JOINT::JOINT_TAG_HASH> m_removedJoints;
+
     ///> node this node was branched from
     NODE* m_parent;
 
@@ -488,7 +569,7 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
+    ///> hash of the items of the parents and the root removed in this node
     std::unordered_set<ITEM*> m_override;
 
     ///> worst case item-item clearance
@@ -497,13 +578,17 @@ private:
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
+    ///> Geometric/Net index of the items added in this node
     INDEX* m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
 
     std::unordered_set<ITEM*> m_garbageItems;
+
+    ///> hulls of the root items (root node only), see obstacleHull()
+    OBSTACLE_HULL_CACHE m_obstacleHulls;
+    std::mutex          m_obstacleHullsLock;
 };
 
 }
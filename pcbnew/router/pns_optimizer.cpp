@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_rect.h>
 #include <cmath>
@@ -32,6 +34,7 @@
 #include "../../include/geometry/shape_simple.h"
 #include "pns_utils.h"
 #include "pns_router.h"
+#include "pns_worker_pool.h"
 
 namespace PNS {
 
@@ -82,7 +85,7 @@ int COST_ESTIMATOR::CornerCost( const LINE& aLine )
 }
 
 
-void COST_ESTIMATOR::Add( LINE& aLine )
+void COST_ESTIMATOR::Add( const LINE& aLine )
 {
     m_lengthCost += aLine.CLine().Length();
     m_cornerCost += CornerCost( aLine );
@@ -128,7 +131,8 @@ OPTIMIZER::OPTIMIZER( NODE* aWorld ) :
     m_collisionKindMask( ITEM::ANY_T ),
     m_effortLevel( MERGE_SEGMENTS ),
     m_keepPostures( false ),
-    m_restrictAreaActive( false )
+    m_restrictAreaActive( false ),
+    m_parallel( false )
 {
 }
 
@@ -382,6 +386,53 @@ bool LINE_RESTRICTIONS::Check( int aVertex1, int aVertex2, const SHAPE_LINE_CHAI
 }
 
 
+/**
+ * Calls aFunc for the candidates 0 .. aCount - 1, on the router workers if parallel
+ * evaluation is enabled and the workers are not busy. aFunc returns true if it accepts
+ * its candidate; the candidates after the first accepted one are skipped, as well as all
+ * remaining ones once the time limit expires.
+ * @return the first accepted candidate, or -1.
+ */
+int OPTIMIZER::forEachCandidate( int aCount, const std::function<bool( int )>& aFunc ) const
+{
+    if( aCount <= 0 )
+        return -1;
+
+    // Candidates are handed out in order, so every candidate below the first accepted one
+    // gets evaluated and the result is the same as the serial one.
+    std::atomic<int> nextCandidate( 0 );
+    std::atomic<int> firstAccepted( aCount );
+
+    auto eval_lambda = [&]( int aWorker )
+    {
+        for( int i = nextCandidate++; i < firstAccepted && !timeExpired(); i = nextCandidate++ )
+        {
+            if( !aFunc( i ) )
+                continue;
+
+            int prev = firstAccepted;
+
+            while( i < prev && !firstAccepted.compare_exchange_weak( prev, i ) )
+                ;
+        }
+    };
+
+    bool done = false;
+
+    if( m_parallel && aCount > 4 )
+    {
+        WORKER_POOL& pool = WORKER_POOL::Instance();
+
+        done = pool.Run( std::min( pool.Size(), ( aCount + 3 ) / 4 - 1 ), eval_lambda );
+    }
+
+    if( !done )
+        eval_lambda( 0 );
+
+    return firstAccepted < aCount ? (int) firstAccepted : -1;
+}
+
+
 bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
 {
     CACHE_VISITOR v( aItem, m_world, m_collisionKindMask );
@@ -451,13 +502,12 @@ bool OPTIMIZER::mergeObtuse( LINE* aLine )
             return current_path.SegmentCount() < segs_pre;
         }
 
-        bool found_anything = false;
-        int n = 0;
+        std::vector<VECTOR2I> merge_points( std::max( n_segs - step, 0 ) );
 
-        while( n < n_segs - step )
+        int n = forEachCandidate( n_segs - step, [&]( int aN ) -> bool
         {
-            const SEG s1 = current_path.CSegment( n );
-            const SEG s2 = current_path.CSegment( n + step );
+            const SEG s1 = current_path.CSegment( aN );
+            const SEG s2 = current_path.CSegment( aN + step );
             SEG s1opt, s2opt;
 
             if( DIRECTION_45( s1 ).IsObtuse( DIRECTION_45( s2 ) ) )
@@ -486,19 +536,20 @@ bool OPTIMIZER::mergeObtuse( LINE* aLine )
 
                     if( !checkColliding( &opt_track ) )
                     {
-                        current_path.Replace( s1.Index() + 1, s2.Index(), ip );
-                        // removeCachedSegments(aLine, s1.Index(), s2.Index());
-                        n_segs = current_path.SegmentCount();
-                        found_anything = true;
-                        break;
+                        merge_points[aN] = ip;
+                        return true;
                     }
                 }
             }
 
-            n++;
-        }
+            return false;
+        } );
 
-        if( !found_anything )
+        bool found_anything = n >= 0;
+
+        if( found_anything )
+            current_path.Replace( n + 1, n + step, merge_points[n] );
+        else
         {
             if( step <= 2 )
             {
@@ -580,7 +631,6 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 
 bool OPTIMIZER::mergeStep( LINE* aLine, SHAPE_LINE_CHAIN& aCurrentPath, int step )
 {
-    int n = 0;
     int n_segs = aCurrentPath.SegmentCount();
 
     int cost_orig = COST_ESTIMATOR::CornerCost( aCurrentPath );
@@ -595,10 +645,12 @@ bool OPTIMIZER::mergeStep( LINE* aLine, SHAPE_LINE_CHAIN& aCurrentPath, int step
 
     restr.Build( m_world, aLine, aCurrentPath, m_restrictArea, m_restrictAreaActive );
 
-    while( n < n_segs - step )
+    std::vector<SHAPE_LINE_CHAIN> picked_paths( std::max( n_segs - step, 0 ) );
+
+    int n = forEachCandidate( n_segs - step, [&]( int aN ) -> bool
     {
-        const SEG s1    = aCurrentPath.CSegment( n );
-        const SEG s2    = aCurrentPath.CSegment( n + step );
+        const SEG s1    = aCurrentPath.CSegment( aN );
+        const SEG s2    = aCurrentPath.CSegment( aN + step );
 
         SHAPE_LINE_CHAIN path[2];
         SHAPE_LINE_CHAIN* picked = NULL;
@@ -610,11 +662,11 @@ bool OPTIMIZER::mergeStep( LINE* aLine, SHAPE_LINE_CHAIN& aCurrentPath, int step
             SHAPE_LINE_CHAIN bypass = DIRECTION_45().BuildInitialTrace( s1.A, s2.B, i );
             cost[i] = INT_MAX;
 
-            bool restrictionsOK = restr.Check ( n, n + step + 1, bypass );
+            bool restrictionsOK = restr.Check ( aN, aN + step + 1, bypass );
 
-            if( n == 0 && orig_start != DIRECTION_45( bypass.CSegment( 0 ) ) )
+            if( aN == 0 && orig_start != DIRECTION_45( bypass.CSegment( 0 ) ) )
                 postureMatch = false;
-            else if( n == n_segs - step && orig_end != DIRECTION_45( bypass.CSegment( -1 ) ) )
+            else if( aN == n_segs - step && orig_end != DIRECTION_45( bypass.CSegment( -1 ) ) )
                 postureMatch = false;
 
             if( restrictionsOK && (postureMatch || !m_keepPostures) && !checkColliding( aLine, bypass ) )
@@ -631,17 +683,18 @@ bool OPTIMIZER::mergeStep( LINE* aLine, SHAPE_LINE_CHAIN& aCurrentPath, int step
         else if( cost[1] < cost_orig )
             picked = &path[1];
 
-        if( picked )
-        {
-            n_segs = aCurrentPath.SegmentCount();
-            aCurrentPath = *picked;
-            return true;
-        }
+        if( !picked )
+            return false;
 
-        n++;
-    }
+        picked_paths[aN] = *picked;
+        return true;
+    } );
 
-    return false;
+    if( n < 0 )
+        return false;
+
+    aCurrentPath = picked_paths[n];
+    return true;
 }
 
 
@@ -909,13 +962,24 @@ int OPTIMIZER::smartPadsSingle( LINE* aLine, ITEM* aPad, bool aEnd, int aEndVert
     bool found = false;
     int p_best = -1;
 
-    for( RtVariant& vp : variants )
+    // Candidates not checked before the time limit expired are considered colliding.
+    std::vector<char> colliding( variants.size(), 1 );
+
+    forEachCandidate( variants.size(), [&]( int aI ) -> bool
+    {
+        LINE tmp( *aLine, std::get<2>( variants[aI] ) );
+
+        colliding[aI] = checkColliding( &tmp );
+        return false;
+    } );
+
+    for( size_t i = 0; i < variants.size(); i++ )
     {
-        LINE tmp( *aLine, std::get<2>( vp ) );
+        RtVariant& vp = variants[i];
         int cost = COST_ESTIMATOR::CornerCost( std::get<2>( vp ) );
         long long int len = std::get<1>( vp );
 
-        if( !checkColliding( &tmp ) )
+        if( !colliding[i] )
         {
             if( cost < min_cost || ( cost == min_cost && len > max_length ) )
             {
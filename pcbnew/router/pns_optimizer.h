@@ -22,13 +22,17 @@
 #ifndef __PNS_OPTIMIZER_H
 #define __PNS_OPTIMIZER_H
 
+#include <functional>
 #include <unordered_map>
 #include <memory>
 
+#include <core/optional.h>
+
 #include <geometry/shape_index_list.h>
 #include <geometry/shape_line_chain.h>
 
 #include "range.h"
+#include "time_limit.h"
 
 namespace PNS {
 
@@ -61,7 +65,7 @@ public:
     static int CornerCost( const SHAPE_LINE_CHAIN& aLine );
     static int CornerCost( const LINE& aLine );
 
-    void Add( LINE& aLine );
+    void Add( const LINE& aLine );
     void Remove( LINE& aLine );
     void Replace( LINE& aOldLine, LINE& aNewLine );
 
@@ -130,6 +134,23 @@ public:
         m_restrictAreaActive = true;
     }
 
+    /**
+     * Function SetParallel()
+     *
+     * Checks the merge and smart pad candidates for collisions on worker threads. The
+     * world must not be modified while optimizing.
+     */
+    void SetParallel( bool aEnabled )
+    {
+        m_parallel = aEnabled;
+    }
+
+    ///> Stops trying new candidates once aLimit expires. The line stays valid.
+    void SetTimeLimit( const TIME_LIMIT& aLimit )
+    {
+        m_timeLimit = aLimit;
+    }
+
 private:
     static const int MaxCachedItems = 256;
 
@@ -152,6 +173,13 @@ private:
     bool mergeDpSegments( DIFF_PAIR *aPair );
     bool mergeDpStep( DIFF_PAIR *aPair, bool aTryP, int step );
 
+    int forEachCandidate( int aCount, const std::function<bool( int )>& aFunc ) const;
+
+    bool timeExpired() const
+    {
+        return m_timeLimit && m_timeLimit->Expired();
+    }
+
     bool checkColliding( ITEM* aItem, bool aUpdateCache = true );
     bool checkColliding( LINE* aLine, const SHAPE_LINE_CHAIN& aOptPath );
 
@@ -179,6 +207,9 @@ private:
 
     BOX2I m_restrictArea;
     bool m_restrictAreaActive;
+
+    bool m_parallel;
+    OPT<TIME_LIMIT> m_timeLimit;
 };
 
 }
@@ -71,6 +71,7 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_logEvents = false;
 }
 
 
@@ -92,10 +93,21 @@ void ROUTER::SyncWorld()
     ClearWorld();
 
     m_world = std::make_unique<NODE>( );
+    m_world->BeginBulkLoad();
     m_iface->SyncWorld( m_world.get() );
+    m_world->EndBulkLoad();
+}
+
+
+void ROUTER::UpdateWorld()
+{
+    if( m_world && !m_world->HasChildren() && m_iface->UpdateWorld( m_world.get() ) )
+        return;
 
+    SyncWorld();
 }
 
+
 void ROUTER::ClearWorld()
 {
     if( m_world )
@@ -214,6 +226,14 @@ bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
     if( !rv )
         return false;
 
+    m_eventLog.Clear();
+
+    if( m_logEvents )
+    {
+        m_eventLog.LogEvent( "mode", VECTOR2I( 0, 0 ), m_mode );
+        m_eventLog.LogEvent( "start", aP, aLayer );
+    }
+
     m_currentEnd = aP;
     m_state = ROUTE_TRACK;
     return rv;
@@ -234,6 +254,9 @@ void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
     switch( m_state )
     {
     case ROUTE_TRACK:
+        if( m_logEvents )
+            m_eventLog.LogEvent( "move", aP );
+
         movePlacing( aP, endItem );
         break;
 
@@ -354,6 +377,13 @@ void ROUTER::movePlacing( const VECTOR2I& aP, ITEM* aEndItem )
 
 
 void ROUTER::CommitRouting( NODE* aNode )
+{
+    StageRouting( aNode );
+    PushStagedRouting();
+}
+
+
+void ROUTER::StageRouting( NODE* aNode )
 {
     NODE::ITEM_VECTOR removed, added;
 
@@ -365,11 +395,16 @@ void ROUTER::CommitRouting( NODE* aNode )
     for( auto item : added )
         m_iface->AddItem( item );
 
-    m_iface->Commit();
     m_world->Commit( aNode );
 }
 
 
+void ROUTER::PushStagedRouting()
+{
+    m_iface->Commit();
+}
+
+
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
     bool rv = false;
@@ -377,6 +412,9 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
     switch( m_state )
     {
     case ROUTE_TRACK:
+        if( m_logEvents )
+            m_eventLog.LogEvent( "fix", aP, aForceFinish );
+
         rv = m_placer->FixRoute( aP, aEndItem, aForceFinish );
         break;
 
@@ -492,6 +530,9 @@ void ROUTER::DumpLog()
 
     if( logger )
         logger->Save( "/tmp/shove.log" );
+
+    // The input events of the last route, for the qa_pcbnew_tools router benchmark
+    m_eventLog.Save( "/tmp/pns_events.log" );
 }
 
 
@@ -35,6 +35,7 @@
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
 #include "pns_itemset.h"
+#include "pns_logger.h"
 #include "pns_node.h"
 
 namespace KIGFX
@@ -92,6 +93,7 @@ enum DRAG_MODE
 
         virtual void SetRouter( ROUTER* aRouter ) = 0;
         virtual void SyncWorld( NODE* aNode ) = 0;
+        virtual bool UpdateWorld( NODE* aNode ) = 0;
         virtual void AddItem( ITEM* aItem ) = 0;
         virtual void RemoveItem( ITEM* aItem ) = 0;
         virtual bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) = 0;
@@ -131,6 +133,14 @@ public:
     void ClearWorld();
     void SyncWorld();
 
+    /**
+     * Function UpdateWorld()
+     *
+     * Applies the board changes made since the last sync to the world, or syncs the
+     * world from scratch if the changes are not known.
+     */
+    void UpdateWorld();
+
     void SetView( KIGFX::VIEW* aView );
 
     bool RoutingInProgress() const;
@@ -163,6 +173,12 @@ public:
 
     void DumpLog();
 
+    /**
+     * Enables the recording of the input events of each route, saved by DumpLog()
+     * for the router replay benchmark.  Disabled by default.
+     */
+    void EnableEventLog( bool aEnable ) { m_logEvents = aEnable; }
+
     RULE_RESOLVER* GetRuleResolver() const
     {
         return m_iface->GetRuleResolver();
@@ -191,6 +207,22 @@ public:
 
     void CommitRouting( NODE* aNode );
 
+    /**
+     * Function StageRouting()
+     *
+     * Applies the changes of aNode to the world and to the board commit being built, without
+     * pushing the commit. Several branches can be staged and pushed together.
+     * @see PushStagedRouting()
+     */
+    void StageRouting( NODE* aNode );
+
+    /**
+     * Function PushStagedRouting()
+     *
+     * Pushes the changes staged so far as a single undo step.
+     */
+    void PushStagedRouting();
+
     /**
      * Applies stored settings.
      * @see Settings()
@@ -272,6 +304,10 @@ private:
     SIZES_SETTINGS m_sizes;
     ROUTER_MODE m_mode;
 
+    ///> Input events of the current route, saved by DumpLog()
+    LOGGER m_eventLog;
+    bool m_logEvents;
+
     wxString m_toolStatusbarName;
     wxString m_failureReason;
 };
@@ -131,6 +131,9 @@ public:
     TIME_LIMIT ShoveTimeLimit() const;
 
     int WalkaroundIterationLimit() const { return m_walkaroundIterationLimit; };
+
+    ///> Time limit of the walkaround and its optimization.  Only applied together with
+    ///> ParallelCandidates().
     TIME_LIMIT WalkaroundTimeLimit() const;
 
     void SetInlineDragEnabled ( bool aEnable ) { m_inlineDragEnabled = aEnable; }
@@ -142,6 +145,12 @@ public:
     bool GetSnapToTracks() const { return m_snapToTracks; }
     bool GetSnapToPads() const { return m_snapToPads; }
 
+    ///> Returns true if walkaround and optimizer candidates are evaluated on worker threads.
+    bool ParallelCandidates() const { return m_parallelCandidates; }
+
+    ///> Enables/disables evaluating walkaround and optimizer candidates on worker threads.
+    void SetParallelCandidates( bool aEnable ) { m_parallelCandidates = aEnable; }
+
 private:
     bool m_shoveVias;
     bool m_startDiagonal;
@@ -156,6 +165,7 @@ private:
     bool m_inlineDragEnabled;
     bool m_snapToTracks;
     bool m_snapToPads;
+    bool m_parallelCandidates;
 
     PNS_MODE m_routingMode;
     PNS_OPTIMIZATION_EFFORT m_optimizerEffort;
@@ -88,20 +88,36 @@ TOOL_BASE::~TOOL_BASE()
 
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
+    if( aReason != RUN )
+    {
+        // The board was reloaded or the view changed: rebuild the world at the next run
+        if( m_router )
+            m_router->ClearWorld();
+
+        return;
+    }
+
     delete m_gridHelper;
-    delete m_iface;
-    delete m_router;
 
-    m_iface = new PNS_KICAD_IFACE;
+    // The world is kept between runs and only updated with the board changes made since
+    if( !m_router )
+    {
+        m_iface = new PNS_KICAD_IFACE;
+        m_router = new ROUTER;
+        m_router->SetInterface( m_iface );
+
+#ifdef DEBUG
+        // The log is only saved from debug builds, see ROUTER_TOOL::handleCommonEvents()
+        m_router->EnableEventLog( true );
+#endif
+    }
+
     m_iface->SetBoard( board() );
     m_iface->SetView( getView() );
     m_iface->SetHostTool( this );
     m_iface->SetDisplayOptions( &( frame()->GetDisplayOptions() ) );
 
-    m_router = new ROUTER;
-    m_router->SetInterface( m_iface );
-    m_router->ClearWorld();
-    m_router->SyncWorld();
+    m_router->UpdateWorld();
     m_router->LoadSettings( m_savedSettings );
     m_router->UpdateSizes( m_savedSizes );
 
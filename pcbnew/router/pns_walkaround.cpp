@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <thread>
+
 #include <core/optional.h>
 
 #include <geometry/shape_line_chain.h>
@@ -27,6 +29,7 @@
 #include "pns_optimizer.h"
 #include "pns_utils.h"
 #include "pns_router.h"
+#include "pns_worker_pool.h"
 
 namespace PNS {
 
@@ -37,6 +40,36 @@ void WALKAROUND::start( const LINE& aInitialPath )
 }
 
 
+int WALKAROUND::countBlockage( bool aWindingDirection, bool aBlocked )
+{
+    if( !m_lockstep )
+    {
+        if( aBlocked )
+            m_recursiveBlockageCount++;
+
+        return m_recursiveBlockageCount;
+    }
+
+    // In the serial walk, the clockwise step of an iteration comes before the
+    // counter-clockwise one and the two share the count
+    m_stepBlockage[ aWindingDirection ? 0 : 1 ] = aBlocked ? 1 : 0;
+
+    int count = m_recursiveBlockageCount + ( aBlocked ? 1 : 0 );
+
+    if( aBlocked && !aWindingDirection )
+    {
+        int cw;
+
+        while( ( cw = m_stepBlockage[0] ) < 0 )
+            std::this_thread::yield();
+
+        count += cw;
+    }
+
+    return count;
+}
+
+
 NODE::OPT_OBSTACLE WALKAROUND::nearestObstacle( const LINE& aPath )
 {
     NODE::OPT_OBSTACLE obs = m_world->NearestObstacle( &aPath, m_itemMask, m_restrictedSet.empty() ? NULL : &m_restrictedSet );
@@ -59,18 +92,20 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
     bool& prev_recursive = aWindingDirection ? m_recursiveCollision[0] : m_recursiveCollision[1];
 
+    VECTOR2I last = aPath.CPoint( -1 );
+    bool blocked = current_obs && ( ( current_obs->m_hull ).PointInside( last )
+                                    || ( current_obs->m_hull ).PointOnEdge( last ) );
+
+    int blockage_count = countBlockage( aWindingDirection, blocked );
+
     if( !current_obs )
         return DONE;
 
     SHAPE_LINE_CHAIN path_pre[2], path_walk[2], path_post[2];
 
-    VECTOR2I last = aPath.CPoint( -1 );
-
-    if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
+    if( blocked )
     {
-        m_recursiveBlockageCount++;
-
-        if( m_recursiveBlockageCount < 3 )
+        if( blockage_count < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -88,12 +123,16 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         return STUCK;
 
 #ifdef DEBUG
-    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
-    m_logger.Log( &path_walk[0], 0, "path-walk" );
-    m_logger.Log( &path_pre[0], 1, "path-pre" );
-    m_logger.Log( &path_post[0], 4, "path-post" );
-    m_logger.Log( &current_obs->m_hull, 2, "hull" );
-    m_logger.Log( current_obs->m_item, 3, "item" );
+    {
+        std::lock_guard<std::mutex> lock( m_loggerLock );
+
+        m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger.Log( &path_walk[0], 0, "path-walk" );
+        m_logger.Log( &path_pre[0], 1, "path-pre" );
+        m_logger.Log( &path_post[0], 4, "path-post" );
+        m_logger.Log( &current_obs->m_hull, 2, "hull" );
+        m_logger.Log( current_obs->m_item, 3, "item" );
+    }
 #endif
 
     int len_pre = path_walk[0].Length();
@@ -144,6 +183,154 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 }
 
 
+const LINE& WALKAROUND::pickPath( const LINE& aPathCw, const LINE& aPathCcw ) const
+{
+    if( m_forceLongerPath )
+        return aPathCw.CLine().Length() > aPathCcw.CLine().Length() ? aPathCw : aPathCcw;
+
+    COST_ESTIMATOR cost_cw, cost_ccw;
+
+    cost_cw.Add( aPathCw );
+    cost_ccw.Add( aPathCcw );
+
+    // a path both shorter and less cornery wins, otherwise the shorter one does
+    if( cost_cw.IsBetter( cost_ccw, 1.0, 1.0 ) )
+        return aPathCcw;
+    else if( cost_ccw.IsBetter( cost_cw, 1.0, 1.0 ) )
+        return aPathCw;
+
+    return cost_cw.GetLengthCost() < cost_ccw.GetLengthCost() ? aPathCw : aPathCcw;
+}
+
+
+bool WALKAROUND::stepDone( const LINE& aPathCw, const LINE& aPathCcw,
+        WALKAROUND_STATUS aStatusCw, WALKAROUND_STATUS aStatusCcw, LINE& aWalkPath ) const
+{
+    if( ( aStatusCw == DONE && aStatusCcw == DONE )
+            || ( aStatusCw == STUCK && aStatusCcw == STUCK ) )
+    {
+        aWalkPath = pickPath( aPathCw, aPathCcw );
+        return true;
+    }
+    else if( aStatusCw == DONE && !m_forceLongerPath )
+    {
+        aWalkPath = aPathCw;
+        return true;
+    }
+    else if( aStatusCcw == DONE && !m_forceLongerPath )
+    {
+        aWalkPath = aPathCcw;
+        return true;
+    }
+
+    return false;
+}
+
+
+void WALKAROUND::routeSerial( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+        WALKAROUND_STATUS& aStatusCcw, LINE& aWalkPath )
+{
+    while( m_iteration < m_iterationLimit && !timeExpired() )
+    {
+        if( aStatusCw != STUCK )
+            aStatusCw = singleStep( aPathCw, true );
+
+        if( aStatusCcw != STUCK )
+            aStatusCcw = singleStep( aPathCcw, false );
+
+        if( stepDone( aPathCw, aPathCcw, aStatusCw, aStatusCcw, aWalkPath ) )
+            return;
+
+        m_iteration++;
+    }
+
+    // out of iterations or out of time
+    aWalkPath = pickPath( aPathCw, aPathCcw );
+}
+
+
+void WALKAROUND::routeParallel( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+        WALKAROUND_STATUS& aStatusCcw, LINE& aWalkPath )
+{
+    // The clockwise path is walked on a worker and the counter-clockwise one here, one
+    // iteration at a time. Both steps of an iteration run together, and the iteration
+    // ends as in the serial walk: same blockage count, same stopping rules.
+    std::atomic<int>  cwIteration( -1 );     // iteration the worker is asked to walk
+    std::atomic<int>  cwDoneIteration( -1 ); // last iteration the worker has walked
+    std::atomic<bool> stop( false );
+    bool              done = false;
+
+    auto cw_lambda = [&]()
+    {
+        for( int i = 0; ; i++ )
+        {
+            while( cwIteration < i && !stop )
+                std::this_thread::yield();
+
+            if( stop )
+                return;
+
+            if( aStatusCw != STUCK )
+                aStatusCw = singleStep( aPathCw, true );
+            else
+                m_stepBlockage[0] = 0;
+
+            cwDoneIteration = i;
+        }
+    };
+
+    auto ccw_lambda = [&]()
+    {
+        while( m_iteration < m_iterationLimit && !timeExpired() )
+        {
+            m_stepBlockage[0] = m_stepBlockage[1] = -1;
+            cwIteration = m_iteration;
+
+            if( aStatusCcw != STUCK )
+                aStatusCcw = singleStep( aPathCcw, false );
+
+            while( cwDoneIteration < m_iteration )
+                std::this_thread::yield();
+
+            m_recursiveBlockageCount += m_stepBlockage[0] + std::max<int>( m_stepBlockage[1], 0 );
+
+            if( stepDone( aPathCw, aPathCcw, aStatusCw, aStatusCcw, aWalkPath ) )
+            {
+                done = true;
+                break;
+            }
+
+            m_iteration++;
+        }
+
+        stop = true;
+    };
+
+    m_lockstep = true;
+
+    bool started = WORKER_POOL::Instance().Run( 1, [&]( int aWorker )
+    {
+        if( aWorker == 0 )
+            ccw_lambda();
+        else
+            cw_lambda();
+    } );
+
+    m_lockstep = false;
+
+    // the workers are busy (for instance running a batch): walk here
+    if( !started )
+    {
+        routeSerial( aPathCw, aPathCcw, aStatusCw, aStatusCcw, aWalkPath );
+        return;
+    }
+
+    // out of iterations or out of time
+    if( !done )
+        aWalkPath = pickPath( aPathCw, aPathCcw );
+}
+
+
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
@@ -177,50 +364,10 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
-
-        if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
-        {
-            int len_cw  = path_cw.CLine().Length();
-            int len_ccw = path_ccw.CLine().Length();
-
-            if( m_forceLongerPath )
-                aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
-            else
-                aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
-
-            break;
-        }
-        else if( s_cw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_cw;
-            break;
-        }
-        else if( s_ccw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_ccw;
-            break;
-        }
-
-        m_iteration++;
-    }
-
-    if( m_iteration == m_iterationLimit )
-    {
-        int len_cw  = path_cw.CLine().Length();
-        int len_ccw = path_ccw.CLine().Length();
-
-        if( m_forceLongerPath )
-            aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
-        else
-            aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
-    }
+    if( m_parallel && s_cw == IN_PROGRESS && s_ccw == IN_PROGRESS )
+        routeParallel( path_cw, path_ccw, s_cw, s_ccw, aWalkPath );
+    else
+        routeSerial( path_cw, path_ccw, s_cw, s_ccw, aWalkPath );
 
     if( m_cursorApproachMode )
     {
@@ -270,7 +417,14 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     if( st == DONE )
     {
         if( aOptimize )
-            OPTIMIZER::Optimize( &aWalkPath, OPTIMIZER::MERGE_OBTUSE, m_world );
+        {
+            OPTIMIZER optimizer( m_world );
+
+            optimizer.SetEffortLevel( OPTIMIZER::MERGE_OBTUSE );
+            optimizer.SetCollisionMask( -1 );
+            optimizer.SetParallel( m_parallel );
+            optimizer.Optimize( &aWalkPath );
+        }
     }
 
     return st;
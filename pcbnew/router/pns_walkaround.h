@@ -22,13 +22,18 @@
 #ifndef __PNS_WALKAROUND_H
 #define __PNS_WALKAROUND_H
 
+#include <atomic>
+#include <mutex>
 #include <set>
 
+#include <core/optional.h>
+
 #include "pns_line.h"
 #include "pns_node.h"
 #include "pns_router.h"
 #include "pns_logger.h"
 #include "pns_algo_base.h"
+#include "time_limit.h"
 
 namespace PNS {
 
@@ -46,10 +51,13 @@ public:
         m_forceLongerPath = false;
         m_forceWinding = false;
         m_cursorApproachMode = false;
+        m_parallel = false;
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
         m_recursiveBlockageCount = 0;
+        m_stepBlockage[0] = m_stepBlockage[1] = -1;
+        m_lockstep = false;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -110,6 +118,24 @@ public:
         m_forceWinding = aEnabled;
     }
 
+    /**
+     * Function SetParallel()
+     *
+     * Walks the clockwise and counter-clockwise paths on separate threads, in lockstep,
+     * so that the result is the same as the serial walk. The world must not be modified
+     * while Route() runs.
+     */
+    void SetParallel( bool aEnabled )
+    {
+        m_parallel = aEnabled;
+    }
+
+    ///> Stops walking (and returns the best path found so far) once aLimit expires.
+    void SetTimeLimit( const TIME_LIMIT& aLimit )
+    {
+        m_timeLimit = aLimit;
+    }
+
     void RestrictToSet( bool aEnabled, const std::set<ITEM*>& aSet )
     {
         if( aEnabled )
@@ -131,10 +157,31 @@ private:
 
     WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
+    int countBlockage( bool aWindingDirection, bool aBlocked );
+
+    bool timeExpired() const
+    {
+        return m_timeLimit && m_timeLimit->Expired();
+    }
+
+    void routeSerial( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+            WALKAROUND_STATUS& aStatusCcw, LINE& aWalkPath );
+    void routeParallel( LINE& aPathCw, LINE& aPathCcw, WALKAROUND_STATUS& aStatusCw,
+            WALKAROUND_STATUS& aStatusCcw, LINE& aWalkPath );
+    bool stepDone( const LINE& aPathCw, const LINE& aPathCcw, WALKAROUND_STATUS aStatusCw,
+            WALKAROUND_STATUS aStatusCcw, LINE& aWalkPath ) const;
+    const LINE& pickPath( const LINE& aPathCw, const LINE& aPathCcw ) const;
 
     NODE* m_world;
 
+    ///> blockages met by both directions in the previous iterations
     int m_recursiveBlockageCount;
+
+    ///> lockstep walk: blockages met by each direction in the current iteration
+    ///> (-1 until the direction has checked for one)
+    std::atomic<int> m_stepBlockage[2];
+    bool m_lockstep;
+
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
@@ -142,10 +189,13 @@ private:
     bool m_cursorApproachMode;
     bool m_forceWinding;
     bool m_forceCw;
+    bool m_parallel;
+    OPT<TIME_LIMIT> m_timeLimit;
     VECTOR2I m_cursorPos;
     NODE::OPT_OBSTACLE m_currentObstacle[2];
     bool m_recursiveCollision[2];
     LOGGER m_logger;
+    std::mutex m_loggerLock;
     std::set<ITEM*> m_restrictedSet;
 };
 
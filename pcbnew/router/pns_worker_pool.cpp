@@ -0,0 +1,117 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "pns_worker_pool.h"
+
+namespace PNS {
+
+WORKER_POOL& WORKER_POOL::Instance()
+{
+    static WORKER_POOL pool;
+
+    return pool;
+}
+
+
+WORKER_POOL::WORKER_POOL() :
+    m_task( nullptr ),
+    m_nextIndex( 0 ),
+    m_toStart( 0 ),
+    m_running( 0 ),
+    m_quit( false )
+{
+    // the thread calling Run() works too
+    int count = std::max<int>( std::thread::hardware_concurrency(), 2 ) - 1;
+
+    for( int ii = 0; ii < count; ++ii )
+        m_threads.emplace_back( &WORKER_POOL::workerLoop, this );
+}
+
+
+WORKER_POOL::~WORKER_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_quit = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+
+bool WORKER_POOL::Run( int aHelpers, const std::function<void( int )>& aTask )
+{
+    std::unique_lock<std::mutex> busy( m_busy, std::try_to_lock );
+
+    if( !busy.owns_lock() || aHelpers < 1 || aHelpers > Size() )
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        m_task = &aTask;
+        m_nextIndex = 1;
+        m_toStart = aHelpers;
+        m_running = aHelpers;
+    }
+
+    m_wakeUp.notify_all();
+
+    aTask( 0 );
+
+    std::unique_lock<std::mutex> lock( m_lock );
+
+    m_finished.wait( lock, [this]() { return m_running == 0; } );
+    m_task = nullptr;
+
+    return true;
+}
+
+
+void WORKER_POOL::workerLoop()
+{
+    std::unique_lock<std::mutex> lock( m_lock );
+
+    while( true )
+    {
+        m_wakeUp.wait( lock, [this]() { return m_quit || m_toStart > 0; } );
+
+        if( m_quit )
+            return;
+
+        const std::function<void( int )>* task = m_task;
+        int index = m_nextIndex++;
+
+        m_toStart--;
+
+        lock.unlock();
+        ( *task )( index );
+        lock.lock();
+
+        if( --m_running == 0 )
+            m_finished.notify_all();
+    }
+}
+
+}
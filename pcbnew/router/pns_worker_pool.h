@@ -0,0 +1,86 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_WORKER_POOL_H
+#define __PNS_WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PNS {
+
+/**
+ * Class WORKER_POOL
+ *
+ * Threads kept alive between the router steps, so that evaluating candidates in parallel
+ * does not start new threads every time. A single task runs at a time: a task started
+ * while another one runs (for instance from a worker) is refused, and the caller does
+ * the work by itself.
+ */
+class WORKER_POOL
+{
+public:
+    ///> The pool shared by the router algorithms, started on first use
+    static WORKER_POOL& Instance();
+
+    ///> Number of worker threads, not counting the thread calling Run()
+    int Size() const
+    {
+        return (int) m_threads.size();
+    }
+
+    /**
+     * Function Run()
+     *
+     * Calls aTask( 0 ) on the calling thread and aTask( 1 ) .. aTask( aHelpers ) on
+     * workers, and waits for all of them to return.
+     * @return false (without calling aTask) if the pool is busy or too small.
+     */
+    bool Run( int aHelpers, const std::function<void( int )>& aTask );
+
+private:
+    WORKER_POOL();
+    ~WORKER_POOL();
+
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+
+    ///> held by the thread running a task
+    std::mutex m_busy;
+
+    std::mutex m_lock;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_finished;
+
+    ///> task being run, the index given to the next worker, the workers still to start it
+    ///> and the ones not done with it yet
+    const std::function<void( int )>* m_task;
+    int m_nextIndex;
+    int m_toStart;
+    int m_running;
+    bool m_quit;
+};
+
+}
+
+#endif    // __PNS_WORKER_POOL_H
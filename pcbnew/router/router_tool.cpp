@@ -441,8 +441,7 @@ bool ROUTER_TOOL::Init()
 
 void ROUTER_TOOL::Reset( RESET_REASON aReason )
 {
-    if( aReason == RUN )
-        TOOL_BASE::Reset( aReason );
+    TOOL_BASE::Reset( aReason );
 }
 
 
@@ -918,7 +917,7 @@ int ROUTER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
         }
         else if( evt->Action() == TA_UNDO_REDO_POST || evt->Action() == TA_MODEL_CHANGE )
         {
-            m_router->SyncWorld();
+            m_router->UpdateWorld();
         }
         else if( evt->IsMotion() )
         {
@@ -1150,7 +1149,7 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    m_router->UpdateWorld();
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
 
     if( m_startItem && m_startItem->IsLocked() )
@@ -1227,7 +1226,7 @@ int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+    m_router->UpdateWorld();
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
     m_startSnapPoint = snapToItem( true, m_startItem, controls()->GetCursorPosition() );
 
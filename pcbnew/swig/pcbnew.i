@@ -74,6 +74,7 @@ class BASE_SET {};
 #include <exporters/gendrill_Excellon_writer.h>
 #include <exporters/gendrill_gerber_writer.h>
 #include <exporters/gerber_jobfile_writer.h>
+#include <exporters/fab_output_job.h>
 
 BOARD *GetBoard(); /* get current editor board */
 %}
@@ -114,6 +115,7 @@ HANDLE_EXCEPTIONS(PLUGIN::FootprintDelete)
 %include <exporters/gendrill_Excellon_writer.h>
 %include <exporters/gendrill_gerber_writer.h>
 %include <exporters/gerber_jobfile_writer.h>
+%include <exporters/fab_output_job.h>
 %include <gal/color4d.h>
 %include <id.h>
 
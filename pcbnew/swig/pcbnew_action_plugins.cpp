@@ -259,6 +259,9 @@ void PCB_EDIT_FRAME::RunActionPlugin( ACTION_PLUGIN* aActionPlugin )
     aActionPlugin->Run();
     ACTION_PLUGINS::SetActionRunning( false );
 
+    // The plugin changes the board items in place, and nothing records these changes
+    currentPcb->ChangeLog().Invalidate();
+
     // Get back the undo buffer to fix some modifications
     PICKED_ITEMS_LIST* oldBuffer = NULL;
 
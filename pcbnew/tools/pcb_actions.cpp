@@ -1145,6 +1145,12 @@ TOOL_ACTION PCB_ACTIONS::routerTuneDiffPairSkew( "pcbnew.LengthTuner.TuneDiffPai
         _( "Tune skew of a differential pair" ), "",
         ps_diff_pair_tune_phase_xpm, AF_ACTIVATE, (void*) PNS::PNS_MODE_TUNE_DIFF_PAIR_SKEW );
 
+TOOL_ACTION PCB_ACTIONS::routerTuneSelectedNets( "pcbnew.LengthTuner.TuneSelectedNets",
+        AS_GLOBAL, 0, "",
+        _( "Tune Lengths of Selected Nets..." ),
+        _( "Tune the lengths of the nets of the selected tracks to the same target" ),
+        ps_tune_length_xpm, AF_NONE, (void*) PNS::PNS_MODE_TUNE_SINGLE );
+
 TOOL_ACTION PCB_ACTIONS::routerInlineDrag( "pcbnew.InteractiveRouter.InlineDrag",
         AS_CONTEXT, 0, "",
         _( "Drag Track/Via" ), _( "Drags tracks and vias without breaking connections" ),
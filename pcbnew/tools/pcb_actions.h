@@ -189,6 +189,9 @@ public:
     /// Activation of the Push and Shove router (skew tuning mode)
     static TOOL_ACTION routerTuneDiffPairSkew;
 
+    /// Tunes the nets of the selected tracks in one go
+    static TOOL_ACTION routerTuneSelectedNets;
+
     /// Activation of the Push and Shove settings dialogs
     static TOOL_ACTION routerSettingsDialog;
     static TOOL_ACTION routerDiffPairDialog;
@@ -312,6 +312,10 @@ void PCB_BASE_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsLis
         }
     }
 
+    // The callers change the items in place, without a BOARD_COMMIT: log the changes for the
+    // copies of the board (the router world)
+    GetBoard()->ChangeLog().RecordModified( *commandToUndo );
+
     if( commandToUndo->GetCount() )
     {
         /* Save the copy in undo list */
@@ -474,6 +478,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
 
             view->Add( eda_item );
             connectivity->Add( item );
+            GetBoard()->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
         }
         break;
 
@@ -495,6 +500,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             item->Move( aRedoCommand ? aList->m_TransformPoint : -aList->m_TransformPoint );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            GetBoard()->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
         }
             break;
 
@@ -505,6 +511,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
                           aRedoCommand ? m_rotationAngle : -m_rotationAngle );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            GetBoard()->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
         }
             break;
 
@@ -515,6 +522,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
                           aRedoCommand ? -m_rotationAngle : m_rotationAngle );
             view->Update( item, KIGFX::GEOMETRY );
             connectivity->Update( item );
+            GetBoard()->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
         }
             break;
 
@@ -524,6 +532,7 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             item->Flip( aList->m_TransformPoint, m_configSettings.m_FlipLeftRight );
             view->Update( item, KIGFX::LAYERS );
             connectivity->Update( item );
+            GetBoard()->ChangeLog().Record( item, BOARD_CHANGE_LOG::MODIFIED );
         }
             break;
 
@@ -73,6 +73,20 @@ WRL2BASE::~WRL2BASE()
 
     m_inlineModels.clear();
 
+    // the child nodes live in m_arena so they must be destroyed before
+    // the arena is released along with the other members
+    std::list< WRL2NODE* >::iterator sC = m_Children.begin();
+    std::list< WRL2NODE* >::iterator eC = m_Children.end();
+
+    while( sC != eC )
+    {
+        (*sC)->SetParent( NULL, false );
+        delete *sC;
+        ++sC;
+    }
+
+    m_Children.clear();
+
     return;
 }
 
@@ -866,7 +880,7 @@ bool WRL2BASE::readTransform( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2TRANSFORM* np = new WRL2TRANSFORM( aParent );
+    WRL2TRANSFORM* np = new( m_arena ) WRL2TRANSFORM( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -886,7 +900,7 @@ bool WRL2BASE::readShape( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2SHAPE* np = new WRL2SHAPE( aParent );
+    WRL2SHAPE* np = new( m_arena ) WRL2SHAPE( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -906,7 +920,7 @@ bool WRL2BASE::readAppearance( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNod
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2APPEARANCE* np = new WRL2APPEARANCE( aParent );
+    WRL2APPEARANCE* np = new( m_arena ) WRL2APPEARANCE( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -926,7 +940,7 @@ bool WRL2BASE::readMaterial( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2MATERIAL* np = new WRL2MATERIAL( aParent );
+    WRL2MATERIAL* np = new( m_arena ) WRL2MATERIAL( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -946,7 +960,7 @@ bool WRL2BASE::readFaceSet( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2FACESET* np = new WRL2FACESET( aParent );
+    WRL2FACESET* np = new( m_arena ) WRL2FACESET( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -966,7 +980,7 @@ bool WRL2BASE::readLineSet( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2LINESET* np = new WRL2LINESET( aParent );
+    WRL2LINESET* np = new( m_arena ) WRL2LINESET( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -986,7 +1000,7 @@ bool WRL2BASE::readPointSet( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2POINTSET* np = new WRL2POINTSET( aParent );
+    WRL2POINTSET* np = new( m_arena ) WRL2POINTSET( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1006,7 +1020,7 @@ bool WRL2BASE::readCoords( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2COORDS* np = new WRL2COORDS( aParent );
+    WRL2COORDS* np = new( m_arena ) WRL2COORDS( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1026,7 +1040,7 @@ bool WRL2BASE::readNorms( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2NORMS* np = new WRL2NORMS( aParent );
+    WRL2NORMS* np = new( m_arena ) WRL2NORMS( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1046,7 +1060,7 @@ bool WRL2BASE::readColor( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2COLOR* np = new WRL2COLOR( aParent );
+    WRL2COLOR* np = new( m_arena ) WRL2COLOR( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1066,7 +1080,7 @@ bool WRL2BASE::readBox( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2BOX* np = new WRL2BOX( aParent );
+    WRL2BOX* np = new( m_arena ) WRL2BOX( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1086,7 +1100,7 @@ bool WRL2BASE::readSwitch( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
     if( NULL != aNode )
         *aNode = NULL;
 
-    WRL2SWITCH* np = new WRL2SWITCH( aParent );
+    WRL2SWITCH* np = new( m_arena ) WRL2SWITCH( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -1131,7 +1145,7 @@ bool WRL2BASE::readInline( WRLPROC& proc, WRL2NODE* aParent, WRL2NODE** aNode )
         return true;
     }
 
-    WRL2INLINE* np = new WRL2INLINE( aParent );
+    WRL2INLINE* np = new( m_arena ) WRL2INLINE( aParent );
 
     if( !np->Read( proc, this ) )
     {
@@ -82,6 +82,8 @@ private:
 
     std::map< std::string, SGNODE* > m_inlineModels;
 
+    WRL2ARENA m_arena;  // storage for all nodes of the model
+
 public:
 
     // functions inherited from WRL2NODE
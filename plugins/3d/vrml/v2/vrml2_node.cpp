@@ -22,6 +22,7 @@
  */
 
 
+#include <cstddef>
 #include <set>
 #include <map>
 #include <utility>
@@ -42,6 +43,94 @@ typedef std::map< std::string, WRL2NODES > NODEMAP;
 static NODEMAP nodenames;
 
 
+// every node allocation is prefixed with a header which records the arena
+// (if any) that the memory was taken from
+union WRL2NODE_HEADER
+{
+    WRL2ARENA*      arena;
+    std::max_align_t align;
+};
+
+#define WRL2ARENA_BLOCK_SIZE ( 64 * 1024 )
+
+
+WRL2ARENA::WRL2ARENA()
+{
+    m_used = 0;
+    m_blockSize = 0;
+    return;
+}
+
+
+WRL2ARENA::~WRL2ARENA()
+{
+    for( char* block : m_blocks )
+        delete [] block;
+
+    m_blocks.clear();
+    return;
+}
+
+
+void* WRL2ARENA::Alloc( size_t aSize )
+{
+    const size_t align = alignof( std::max_align_t );
+    aSize = ( aSize + align - 1 ) & ~( align - 1 );
+
+    if( m_blocks.empty() || m_used + aSize > m_blockSize )
+    {
+        m_blockSize = std::max( (size_t) WRL2ARENA_BLOCK_SIZE, aSize );
+        m_blocks.push_back( new char[m_blockSize] );
+        m_used = 0;
+    }
+
+    void* mem = m_blocks.back() + m_used;
+    m_used += aSize;
+
+    return mem;
+}
+
+
+void* WRL2NODE::operator new( size_t aSize )
+{
+    WRL2NODE_HEADER* hdr = (WRL2NODE_HEADER*) ::operator new( sizeof( WRL2NODE_HEADER ) + aSize );
+    hdr->arena = NULL;
+
+    return hdr + 1;
+}
+
+
+void* WRL2NODE::operator new( size_t aSize, WRL2ARENA& aArena )
+{
+    WRL2NODE_HEADER* hdr = (WRL2NODE_HEADER*) aArena.Alloc( sizeof( WRL2NODE_HEADER ) + aSize );
+    hdr->arena = &aArena;
+
+    return hdr + 1;
+}
+
+
+void WRL2NODE::operator delete( void* aNode )
+{
+    if( NULL == aNode )
+        return;
+
+    WRL2NODE_HEADER* hdr = (WRL2NODE_HEADER*) aNode - 1;
+
+    // arena memory is reclaimed in a single step when the arena is destroyed
+    if( NULL == hdr->arena )
+        ::operator delete( hdr );
+
+    return;
+}
+
+
+void WRL2NODE::operator delete( void* /* aNode */, WRL2ARENA& /* aArena */ )
+{
+    // only invoked if a constructor throws; the memory remains in the arena
+    return;
+}
+
+
 WRL2NODE::WRL2NODE()
 {
     m_sgNode = NULL;
@@ -43,14 +43,42 @@
 #ifndef VRML2_NODE_H
 #define VRML2_NODE_H
 
+#include <cstddef>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "wrlproc.h"
 
 class WRL2BASE;
 class SGNODE;
 
+
+/**
+ * Class WRL2ARENA
+ * is a simple bump allocator used to hold the nodes of a single VRML2 model.
+ * Memory handed out by the arena is only reclaimed when the arena itself is
+ * destroyed; this avoids a heap allocation per node when reading large models
+ * and releases the entire node tree at once after translation to SGNODEs.
+ */
+class WRL2ARENA
+{
+private:
+    std::vector< char* > m_blocks;  // allocated memory blocks
+    size_t m_used;                  // bytes used in the last block
+    size_t m_blockSize;             // size of the last block
+
+public:
+    WRL2ARENA();
+    ~WRL2ARENA();
+
+    /**
+     * Function Alloc
+     * returns a block of at least aSize bytes aligned for any fundamental type
+     */
+    void* Alloc( size_t aSize );
+};
+
 /**
  * Class WRL2NODE
  * represents the base class of all VRML2 nodes
@@ -127,6 +155,16 @@ public:
     WRL2NODE();
     virtual ~WRL2NODE();
 
+    /**
+     * Nodes are created with new( aArena ) by the WRL2BASE which owns the model;
+     * the corresponding delete runs the destructor but leaves the memory to be
+     * released with the arena. A plain new is still available for top level nodes.
+     */
+    static void* operator new( size_t aSize );
+    static void* operator new( size_t aSize, WRL2ARENA& aArena );
+    static void operator delete( void* aNode );
+    static void operator delete( void* aNode, WRL2ARENA& aArena );
+
     // read data via the given file processor and WRL2BASE object
     virtual bool Read( WRLPROC& proc, WRL2BASE* aTopNode ) = 0;
 
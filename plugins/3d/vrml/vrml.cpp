@@ -177,14 +177,14 @@ public:
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
 {
-    FILE_LINE_READER* modelFile = NULL;
+    LINE_READER* modelFile = NULL;
     SCENEGRAPH* scene = NULL;
 
     try
     {
-        // set the max char limit to 8MB; if a VRML file contains
-        // longer lines then perhaps it shouldn't be used
-        modelFile = new FILE_LINE_READER( aFileName, 0, 8388608 );
+        // the whole file is read into memory in one go; set the max char limit
+        // to 8MB; if a VRML file contains longer lines then perhaps it shouldn't be used
+        modelFile = new WRLBUFFER_READER( aFileName, 8388608 );
     }
     catch( IO_ERROR & )
     {
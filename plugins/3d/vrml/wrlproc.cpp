@@ -21,11 +21,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
+#include <wx/intl.h>
 #include "wrlproc.h"
 
 #define GETLINE do {\
@@ -46,6 +50,98 @@
     } } while( 0 )
 
 
+// returns true if the character may legally follow a numeric token
+static inline bool isTokenEnd( char aChar )
+{
+    return aChar <= 0x20 || ',' == aChar
+        || '{' == aChar || '}' == aChar
+        || '[' == aChar || ']' == aChar;
+}
+
+
+WRLBUFFER_READER::WRLBUFFER_READER( const wxString& aFileName, unsigned aMaxLineLength ) :
+    LINE_READER( aMaxLineLength ), m_ndx( 0 )
+{
+    FILE* fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    m_source = aFileName;
+
+    // read the file in large chunks rather than relying on a file size query so that
+    // non-seekable sources and files which change size while being read are handled
+    const size_t chunk = 1 << 20;
+    size_t used = 0;
+
+    if( fseek( fp, 0, SEEK_END ) == 0 )
+    {
+        long fsize = ftell( fp );
+
+        if( fsize > 0 )
+            m_data.reserve( (size_t) fsize + chunk );
+
+        fseek( fp, 0, SEEK_SET );
+    }
+
+    while( true )
+    {
+        m_data.resize( used + chunk );
+        size_t nread = fread( &m_data[used], 1, chunk, fp );
+        used += nread;
+
+        if( nread < chunk )
+            break;
+    }
+
+    bool failed = ferror( fp ) != 0;
+    fclose( fp );
+    m_data.resize( used );
+
+    if( failed )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to read file \"%s\"" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+}
+
+
+char* WRLBUFFER_READER::ReadLine()
+{
+    m_length = 0;
+
+    if( m_ndx < m_data.size() )
+    {
+        const char* start = &m_data[m_ndx];
+        size_t remain = m_data.size() - m_ndx;
+        const char* eol = (const char*) memchr( start, '\n', remain );
+        size_t len = eol ? (size_t)( eol - start ) + 1 : remain;
+
+        if( len >= m_maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        if( len + 1 > m_capacity )
+            expandCapacity( len + 1 );
+
+        memcpy( m_line, start, len );
+        m_length = len;
+        m_ndx += len;
+    }
+
+    m_line[m_length] = 0;
+
+    // as with FILE_LINE_READER the line number is incremented even at EOF
+    ++m_lineNum;
+
+    return m_length ? m_line : NULL;
+}
+
+
 WRLPROC::WRLPROC( LINE_READER* aLineReader )
 {
     m_fileVersion = VRML_INVALID;
@@ -811,26 +907,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !readFloatToken( aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -871,36 +948,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
-    {
-        std::ostringstream ostr;
-        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline<< ", char " << linepos << " -- ";
-        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] " << m_error;
-        m_error = ostr.str();
-
-        return false;
-    }
-
-    if( std::string::npos != tmp.find( "0x" ) )
-    {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !readIntToken( aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -945,29 +993,25 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
     float trot[4];
 
     for( int i = 0; i < 4; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        // the components of a tuple may be split across lines
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
+            ostr << " * [INFO] unexpected end of file in space delimited quartet";
             m_error = ostr.str();
 
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !readFloatToken( trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -979,7 +1023,6 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
 
             return false;
         }
-
     }
 
     aSFRotation.x = trot[0];
@@ -1017,30 +1060,25 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[2];
 
     for( int i = 0; i < 2; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        // the components of a tuple may be split across lines
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
+            ostr << " * [INFO] unexpected end of file in space delimited pair";
             m_error = ostr.str();
 
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !readFloatToken( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1052,7 +1090,6 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
 
             return false;
         }
-
     }
 
     aSFVec2f.x = tcol[0];
@@ -1089,37 +1126,25 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
-
     float tcol[3];
 
     for( int i = 0; i < 3; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        // the components of a tuple may be split across lines
+        if( !EatSpace() )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
+            ostr << " * [INFO] unexpected end of file in space delimited triplet";
             m_error = ostr.str();
 
             return false;
         }
 
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !readFloatToken( tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1132,6 +1157,12 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
+        // ignore any commas
+        if( !EatSpace() )
+            return false;
+
+        if( ',' == m_buf[m_bufpos] )
+            Pop();
     }
 
     aSFVec3f.x = tcol[0];
@@ -1936,6 +1967,52 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
 }
 
 
+bool WRLPROC::readFloatToken( float& aValue )
+{
+    const char* start = m_buf.c_str() + m_bufpos;
+    char* end = NULL;
+
+    aValue = strtof( start, &end );
+
+    if( end == start || !isTokenEnd( *end ) )
+        return false;
+
+    m_bufpos += end - start;
+
+    // a comma is a special instance of blank space
+    if( ',' == *end )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::readIntToken( int& aValue )
+{
+    const char* start = m_buf.c_str() + m_bufpos;
+    const char* digits = ( '-' == *start || '+' == *start ) ? start + 1 : start;
+    char* end = NULL;
+
+    // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
+    // this instance we do no enforce case.
+    int base = ( '0' == digits[0] && ( 'x' == digits[1] || 'X' == digits[1] ) ) ? 16 : 10;
+
+    errno = 0;
+    long val = strtol( start, &end, base );
+
+    if( end == start || ERANGE == errno || !isTokenEnd( *end ) )
+        return false;
+
+    aValue = (int) val;
+    m_bufpos += end - start;
+
+    if( ',' == *end )
+        ++m_bufpos;
+
+    return true;
+}
+
+
 bool WRLPROC::eof( void )
 {
     return m_eof;
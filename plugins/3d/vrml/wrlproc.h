@@ -37,6 +37,36 @@
 #include "richio.h"
 #include "wrltypes.h"
 
+
+/**
+ * Class WRLBUFFER_READER
+ * is a LINE_READER which pulls the entire model file into memory with a single
+ * read and then hands out lines by scanning that buffer. Vendor models can be
+ * tens of megabytes in size and the per-character stdio access of FILE_LINE_READER
+ * dominates the parse time in such cases.
+ */
+class WRLBUFFER_READER : public LINE_READER
+{
+private:
+    std::vector< char > m_data;     // file contents
+    size_t m_ndx;                   // offset of the next line within m_data
+
+public:
+    /**
+     * Constructor WRLBUFFER_READER
+     * reads the whole of the named file into memory.
+     *
+     * @param aFileName is the name of the file to read
+     * @param aMaxLineLength is the maximum line length accepted by ReadLine()
+     * @throw IO_ERROR if the file cannot be opened or read
+     */
+    WRLBUFFER_READER( const wxString& aFileName,
+                      unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    char* ReadLine() override;
+};
+
+
 class WRLPROC
 {
 private:
@@ -58,6 +88,13 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // readFloatToken and readIntToken convert the number which starts at m_bufpos
+    // in place without first copying the token to a temporary string. The number
+    // must be delimited by white space, a comma, a brace or a bracket; a comma
+    // immediately following the number is consumed.
+    bool readFloatToken( float& aValue );
+    bool readIntToken( int& aValue );
+
 public:
     WRLPROC( LINE_READER* aLineReader );
     ~WRLPROC();
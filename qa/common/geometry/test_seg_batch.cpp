@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <random>
+
+#include <geometry/seg_batch.h>
+#include <geometry/shape_line_chain.h>
+
+/**
+ * Collision of a segment with a line chain, checked one segment after the other as
+ * SHAPE_LINE_CHAIN::Collide() did before the batched kernels
+ */
+static bool refCollide( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg, int aClearance )
+{
+    BOX2I              box_a( aSeg.A, aSeg.B - aSeg.A );
+    BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+    {
+        const SEG s = aChain.CSegment( i );
+        BOX2I     box_b( s.A, s.B - s.A );
+
+        if( box_a.SquaredDistance( box_b ) < dist_sq && s.Collide( aSeg, aClearance ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+static SHAPE_LINE_CHAIN randomChain( std::mt19937& aRng, int aRange, int aPoints )
+{
+    std::uniform_int_distribution<int> coord( -aRange, aRange );
+    SHAPE_LINE_CHAIN                   chain;
+    VECTOR2I                           p( coord( aRng ), coord( aRng ) );
+
+    for( int i = 0; i < aPoints; i++ )
+    {
+        chain.Append( p );
+        p += VECTOR2I( coord( aRng ) / 10, coord( aRng ) / 10 );
+    }
+
+    return chain;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SegBatch )
+
+
+/**
+ * Check the batched segment to chain collisions against the segment by segment ones, with
+ * chains longer and shorter than a batch and all sorts of clearances
+ */
+BOOST_AUTO_TEST_CASE( SegmentToChain )
+{
+    std::mt19937 rng( 1 );
+
+    for( int range : { 100, 100000, 100000000 } )
+    {
+        std::uniform_int_distribution<int> coord( -range, range );
+        std::uniform_int_distribution<int> clearance( 1, range / 5 );
+
+        for( int i = 0; i < 2000; i++ )
+        {
+            SHAPE_LINE_CHAIN chain = randomChain( rng, range, 1 + i % ( 2 * SEG_BATCH::SIZE + 7 ) );
+            SEG              seg( VECTOR2I( coord( rng ), coord( rng ) ),
+                                  VECTOR2I( coord( rng ), coord( rng ) ) );
+            int              cl = clearance( rng );
+
+            BOOST_CHECK_EQUAL( chain.Collide( seg, cl ), refCollide( chain, seg, cl ) );
+        }
+    }
+}
+
+
+/**
+ * Check the batched chain to chain collisions against the segment by segment ones
+ */
+BOOST_AUTO_TEST_CASE( ChainToChain )
+{
+    std::mt19937 rng( 2 );
+
+    for( int i = 0; i < 2000; i++ )
+    {
+        SHAPE_LINE_CHAIN a = randomChain( rng, 10000, 1 + i % 150 );
+        SHAPE_LINE_CHAIN b = randomChain( rng, 10000, 1 + i % 13 );
+        int              cl = 1 + i % 2000;
+        bool             expected = false;
+
+        for( int j = 0; j < b.SegmentCount() && !expected; j++ )
+            expected = refCollide( a, b.CSegment( j ), cl );
+
+        BOOST_CHECK_EQUAL( a.Collide( b, cl ), expected );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <wx/wx.h>
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <plugins/3dapi/ifsg_api.h>
+#include <plugins/ldr/3d/pluginldr3D.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+using CLOCK = std::chrono::steady_clock;
+using LOAD_DURATION = std::chrono::milliseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "reps",
+            _( "number of times each model is loaded" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "VRML plugin library" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "model files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum VRML_BENCH_RET_CODES
+{
+    PLUGIN_LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    MODEL_LOAD_FAILED,
+};
+
+
+/**
+ * Load a model file through the plugin a number of times and report the
+ * fastest, average and slowest load times. The time includes parsing as
+ * well as the translation to, and destruction of, the scene graph.
+ */
+static bool benchmarkModel( KICAD_PLUGIN_LDR_3D& aPlugin, const wxString& aFileName, long aReps )
+{
+    std::vector<LOAD_DURATION> times;
+    wxULongLong fileSize = wxFileName::GetSize( aFileName );
+
+    for( long i = 0; i < aReps; ++i )
+    {
+        CLOCK::time_point start = CLOCK::now();
+        SCENEGRAPH* scene = aPlugin.Load( aFileName.ToUTF8() );
+
+        if( !scene )
+        {
+            std::cerr << "Failed to load " << aFileName << std::endl;
+            return false;
+        }
+
+        S3D::DestroyNode( (SGNODE*) scene );
+        times.push_back( std::chrono::duration_cast<LOAD_DURATION>( CLOCK::now() - start ) );
+    }
+
+    LOAD_DURATION total = LOAD_DURATION::zero();
+
+    for( const LOAD_DURATION& t : times )
+        total += t;
+
+    std::cout << wxString::Format( "%-40s %10s bytes  min %6d ms  avg %6d ms  max %6d ms",
+                         wxFileName( aFileName ).GetFullName(), fileSize.ToString(),
+                         (int) std::min_element( times.begin(), times.end() )->count(),
+                         (int) ( total.count() / (long) times.size() ),
+                         (int) std::max_element( times.begin(), times.end() )->count() )
+              << std::endl;
+
+    return true;
+}
+
+
+int vrml_benchmark_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program times the loading of large VRML models through the given "
+               "3D model plugin library." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long reps = 5;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( 1L, reps );
+
+    KICAD_PLUGIN_LDR_3D plugin;
+
+    if( !plugin.Open( cl_parser.GetParam( 0 ) ) )
+    {
+        std::cerr << "Could not open plugin " << cl_parser.GetParam( 0 ) << ": "
+                  << plugin.GetLastError() << std::endl;
+        return PLUGIN_LOAD_FAILED;
+    }
+
+    std::cout << "VRML load benchmark, " << reps << " repetitions" << std::endl;
+
+    for( size_t i = 1; i < cl_parser.GetParamCount(); ++i )
+    {
+        if( !benchmarkModel( plugin, cl_parser.GetParam( i ), reps ) )
+            return MODEL_LOAD_FAILED;
+    }
+
+    plugin.Close();
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "vrml_benchmark",
+        "Benchmark the loading of VRML models through the 3D model plugin",
+        vrml_benchmark_func,
+} );
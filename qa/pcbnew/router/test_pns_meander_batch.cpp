@@ -0,0 +1,267 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/pns_headless_iface.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <router/pns_meander_batch.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_segment.h>
+
+
+/**
+ * A board with straight horizontal tracks, one per net, and a router world synced from it.
+ * The board is not changed by the router: the tuned traces are only in the world.
+ */
+struct MEANDER_BATCH_FIXTURE
+{
+    MEANDER_BATCH_FIXTURE()
+    {
+        m_iface.SetBoard( &m_board );
+        m_router.SetInterface( &m_iface );
+    }
+
+    /**
+     * Add a net with a single straight track of length aLength, at height aY.
+     * @param aName the net name, "D<net code>" if empty.
+     * @return the net code.
+     */
+    int AddNet( int aY, int aLength, const wxString& aName = wxEmptyString )
+    {
+        int           code = m_board.GetNetCount();
+        wxString      name = aName.IsEmpty() ? wxString::Format( "D%d", code ) : aName;
+        NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, name, code );
+
+        m_board.Add( net );
+
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( wxPoint( 0, aY ) );
+        track->SetEnd( wxPoint( aLength, aY ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( code );
+        m_board.Add( track );
+
+        return code;
+    }
+
+    /**
+     * @return the length of the tracks of net aNet in the router world.
+     */
+    long long int NetLength( int aNet )
+    {
+        std::set<PNS::ITEM*> items;
+        long long int        length = 0;
+
+        m_router.GetWorld()->AllItemsInNet( aNet, items );
+
+        for( PNS::ITEM* item : items )
+        {
+            if( item->OfKind( PNS::ITEM::SEGMENT_T ) )
+                length += static_cast<PNS::SEGMENT*>( item )->Seg().Length();
+        }
+
+        return length;
+    }
+
+    /**
+     * Add the two nets of the differential pair aName, as straight tracks of length aLength
+     * spaced so that they are coupled.
+     */
+    void AddPair( const wxString& aName, int aLength, int& aNetP, int& aNetN )
+    {
+        aNetP = AddNet( 0, aLength, aName + "+" );
+        aNetN = AddNet( Millimeter2iu( 0.45 ), aLength, aName + "-" );
+    }
+
+    PNS::MEANDER_SETTINGS Settings( int aTargetLength ) const
+    {
+        PNS::MEANDER_SETTINGS settings;
+
+        settings.m_targetLength = aTargetLength;
+        settings.m_maxAmplitude = Millimeter2iu( 1 );
+        settings.m_spacing = Millimeter2iu( 0.6 );
+        settings.m_lengthTolerance = Millimeter2iu( 0.1 );
+
+        return settings;
+    }
+
+    BOARD                             m_board;
+    KI_TEST::PNS_KICAD_IFACE_HEADLESS m_iface;
+    PNS::ROUTER                       m_router;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PnsMeanderBatch, MEANDER_BATCH_FIXTURE )
+
+
+/**
+ * Tune nets far enough apart to be tuned in parallel, as the lines of a bus.
+ */
+BOOST_AUTO_TEST_CASE( TunesSeveralNets )
+{
+    const int             target = Millimeter2iu( 55 );
+    PNS::MEANDER_SETTINGS settings = Settings( target );
+    std::vector<int>      nets;
+
+    for( int i = 0; i < 4; i++ )
+        nets.push_back( AddNet( i * Millimeter2iu( 5 ), Millimeter2iu( 40 ) ) );
+
+    m_router.SyncWorld();
+
+    PNS::MEANDER_BATCH batch( &m_router );
+
+    for( int net : nets )
+        batch.AddJob( net, PNS::PNS_MODE_TUNE_SINGLE, settings );
+
+    BOOST_CHECK_EQUAL( batch.Run(), (int) nets.size() );
+
+    for( size_t i = 0; i < nets.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Net " << nets[i] )
+        {
+            BOOST_CHECK( batch.Jobs()[i].m_done );
+            BOOST_CHECK( batch.Jobs()[i].m_status == PNS::MEANDER_PLACER_BASE::TUNED );
+            BOOST_CHECK_LE( std::abs( NetLength( nets[i] ) - target ),
+                            settings.m_lengthTolerance );
+        }
+    }
+}
+
+
+/**
+ * Nets close to each other are tuned one after another, each one against the tuned
+ * traces of the previous ones.
+ */
+BOOST_AUTO_TEST_CASE( TunesNeighbourNets )
+{
+    const int             target = Millimeter2iu( 55 );
+    PNS::MEANDER_SETTINGS settings = Settings( target );
+    std::vector<int>      nets;
+
+    for( int i = 0; i < 3; i++ )
+        nets.push_back( AddNet( i * Millimeter2iu( 4 ), Millimeter2iu( 40 ) ) );
+
+    m_router.SyncWorld();
+
+    PNS::MEANDER_BATCH batch( &m_router );
+
+    for( int net : nets )
+        batch.AddJob( net, PNS::PNS_MODE_TUNE_SINGLE, settings );
+
+    BOOST_CHECK_EQUAL( batch.Run(), (int) nets.size() );
+
+    for( size_t i = 0; i < nets.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Net " << nets[i] )
+        {
+            BOOST_CHECK( batch.Jobs()[i].m_status == PNS::MEANDER_PLACER_BASE::TUNED );
+            BOOST_CHECK_LE( std::abs( NetLength( nets[i] ) - target ),
+                            settings.m_lengthTolerance );
+        }
+    }
+}
+
+
+/**
+ * A net listed twice is only tuned by its first job.
+ */
+BOOST_AUTO_TEST_CASE( TunesDuplicateNetOnce )
+{
+    const int             target = Millimeter2iu( 55 );
+    PNS::MEANDER_SETTINGS settings = Settings( target );
+    int                   net = AddNet( 0, Millimeter2iu( 40 ) );
+
+    m_router.SyncWorld();
+
+    PNS::MEANDER_BATCH batch( &m_router );
+
+    batch.AddJob( net, PNS::PNS_MODE_TUNE_SINGLE, settings );
+    batch.AddJob( net, PNS::PNS_MODE_TUNE_SINGLE, Settings( Millimeter2iu( 70 ) ) );
+
+    BOOST_CHECK_EQUAL( batch.Run(), 1 );
+    BOOST_CHECK( batch.Jobs()[0].m_done );
+    BOOST_CHECK( !batch.Jobs()[1].m_done );
+    BOOST_CHECK_LE( std::abs( NetLength( net ) - target ), settings.m_lengthTolerance );
+}
+
+
+/**
+ * Both lines of a differential pair are tuned together, and none of them is lost.
+ */
+BOOST_AUTO_TEST_CASE( TunesDiffPair )
+{
+    const int             length = Millimeter2iu( 40 );
+    PNS::MEANDER_SETTINGS settings = Settings( Millimeter2iu( 50 ) );
+    int                   netP, netN;
+
+    AddPair( "DP", length, netP, netN );
+    m_router.SyncWorld();
+
+    PNS::MEANDER_BATCH batch( &m_router );
+
+    batch.AddJob( netP, PNS::PNS_MODE_TUNE_DIFF_PAIR, settings );
+
+    BOOST_CHECK_EQUAL( batch.Run(), 1 );
+    BOOST_CHECK( batch.Jobs()[0].m_done );
+    BOOST_CHECK_GT( NetLength( netP ), length );
+    BOOST_CHECK_GT( NetLength( netN ), length );
+}
+
+
+/**
+ * Skew tuning lengthens a single line of the pair, and leaves the other one in place.
+ */
+BOOST_AUTO_TEST_CASE( TunesDiffPairSkew )
+{
+    const int             length = Millimeter2iu( 40 );
+    PNS::MEANDER_SETTINGS settings = Settings( length );
+    int                   netP, netN;
+
+    settings.m_targetSkew = Millimeter2iu( 3 );
+
+    AddPair( "DP", length, netP, netN );
+    m_router.SyncWorld();
+
+    PNS::MEANDER_BATCH batch( &m_router );
+
+    batch.AddJob( netP, PNS::PNS_MODE_TUNE_DIFF_PAIR_SKEW, settings );
+
+    BOOST_CHECK_EQUAL( batch.Run(), 1 );
+    BOOST_CHECK( batch.Jobs()[0].m_done );
+    BOOST_CHECK_EQUAL( NetLength( netN ), length );
+    BOOST_CHECK_LE( std::abs( NetLength( netP ) - NetLength( netN ) - settings.m_targetSkew ),
+                    settings.m_lengthTolerance );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,268 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <pcbnew_utils/pns_headless_iface.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <undo_redo_container.h>
+
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_segment.h>
+
+
+/**
+ * A headless router interface adding the tracks committed by the router to the board,
+ * as the BOARD_COMMIT of the real interface does.
+ */
+class WORLD_UPDATE_IFACE : public KI_TEST::PNS_KICAD_IFACE_HEADLESS
+{
+public:
+    void SetCommitBoard( BOARD* aBoard )
+    {
+        m_commitBoard = aBoard;
+    }
+
+    void AddItem( PNS::ITEM* aItem ) override
+    {
+        if( BOARD_CONNECTED_ITEM* item = createBoardItem( aItem ) )
+            m_added.push_back( item );
+    }
+
+    void Commit() override
+    {
+        for( BOARD_CONNECTED_ITEM* item : m_added )
+            m_commitBoard->Add( item );
+
+        m_added.clear();
+    }
+
+private:
+    BOARD*                             m_commitBoard = nullptr;
+    std::vector<BOARD_CONNECTED_ITEM*> m_added;
+};
+
+
+/**
+ * A board with a single track, and a router world synced from it.
+ */
+struct WORLD_UPDATE_FIXTURE
+{
+    WORLD_UPDATE_FIXTURE()
+    {
+        NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, "D1", 1 );
+
+        m_board.Add( net );
+
+        m_track = new TRACK( &m_board );
+        m_track->SetStart( wxPoint( 0, 0 ) );
+        m_track->SetEnd( wxPoint( Millimeter2iu( 10 ), 0 ) );
+        m_track->SetWidth( Millimeter2iu( 0.25 ) );
+        m_track->SetLayer( F_Cu );
+        m_track->SetNetCode( net->GetNet() );
+        m_board.Add( m_track );
+
+        m_iface.SetBoard( &m_board );
+        m_iface.SetCommitBoard( &m_board );
+        m_router.SetInterface( &m_iface );
+        m_router.SyncWorld();
+    }
+
+    /**
+     * Change the track in place, as the global track edit dialog and the action plugins do.
+     */
+    void EditTrack()
+    {
+        m_track->SetWidth( Millimeter2iu( 0.5 ) );
+        m_track->SetLayer( B_Cu );
+        m_track->SetEnd( wxPoint( Millimeter2iu( 20 ), 0 ) );
+    }
+
+    /**
+     * Add a second track to the net of the first one.
+     */
+    TRACK* AddTrack()
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( wxPoint( 0, Millimeter2iu( 5 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( m_track->GetNetCode() );
+        m_board.Add( track );
+
+        return track;
+    }
+
+    ///> @return the number of items of the net of the tracks in the router world
+    size_t WorldNetItemCount()
+    {
+        std::set<PNS::ITEM*> items;
+
+        m_router.GetWorld()->AllItemsInNet( m_track->GetNetCode(), items );
+
+        return items.size();
+    }
+
+    /**
+     * Check the router world holds the edited track, and only it.
+     */
+    void CheckWorldTrack()
+    {
+        PNS::ITEM* item = m_router.GetWorld()->FindItemByParent( m_track );
+
+        BOOST_REQUIRE( item );
+        BOOST_REQUIRE( item->OfKind( PNS::ITEM::SEGMENT_T ) );
+
+        PNS::SEGMENT* seg = static_cast<PNS::SEGMENT*>( item );
+
+        BOOST_CHECK_EQUAL( seg->Width(), m_track->GetWidth() );
+        BOOST_CHECK_EQUAL( seg->Layers().Start(), B_Cu );
+        BOOST_CHECK_EQUAL( seg->Seg().B, VECTOR2I( m_track->GetEnd() ) );
+
+        std::set<PNS::ITEM*> items;
+
+        m_router.GetWorld()->AllItemsInNet( m_track->GetNetCode(), items );
+        BOOST_CHECK_EQUAL( items.size(), 1u );
+    }
+
+    BOARD              m_board;
+    TRACK*             m_track;
+    WORLD_UPDATE_IFACE m_iface;
+    PNS::ROUTER        m_router;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PnsWorldUpdate, WORLD_UPDATE_FIXTURE )
+
+
+/**
+ * A track changed in place and saved in the undo list, without a BOARD_COMMIT.
+ */
+BOOST_AUTO_TEST_CASE( TrackEditSavedInUndoList )
+{
+    PICKED_ITEMS_LIST undoList;
+
+    undoList.PushItem( ITEM_PICKER( m_track, UR_CHANGED ) );
+
+    // As recorded by PCB_BASE_EDIT_FRAME::SaveCopyInUndoList()
+    m_board.ChangeLog().RecordModified( undoList );
+    EditTrack();
+
+    m_router.UpdateWorld();
+
+    CheckWorldTrack();
+}
+
+
+/**
+ * A track changed in place without any record, then the log invalidated (action plugins).
+ */
+BOOST_AUTO_TEST_CASE( TrackEditWithInvalidatedLog )
+{
+    EditTrack();
+    m_board.ChangeLog().Invalidate();
+
+    m_router.UpdateWorld();
+
+    CheckWorldTrack();
+}
+
+
+/**
+ * Tracks added, removed and modified by board commits are replayed on the world.
+ */
+BOOST_AUTO_TEST_CASE( CommitChangesReplayed )
+{
+    TRACK* added = AddTrack();
+
+    m_router.UpdateWorld();
+
+    BOOST_CHECK( m_router.GetWorld()->FindItemByParent( added ) );
+    BOOST_CHECK_EQUAL( WorldNetItemCount(), 2u );
+
+    // As recorded by BOARD_COMMIT::Push()
+    EditTrack();
+    m_board.ChangeLog().Record( m_track, BOARD_CHANGE_LOG::MODIFIED );
+    m_board.Remove( added );
+
+    m_router.UpdateWorld();
+
+    BOOST_CHECK( !m_router.GetWorld()->FindItemByParent( added ) );
+    CheckWorldTrack();
+
+    delete added;
+}
+
+
+/**
+ * The tracks committed by the router are in its world already, and are not added twice.
+ */
+BOOST_AUTO_TEST_CASE( RouterCommitsSkipped )
+{
+    PNS::NODE* branch = m_router.GetWorld()->Branch();
+    SEG        s( VECTOR2I( 0, Millimeter2iu( 5 ) ), VECTOR2I( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ) );
+
+    std::unique_ptr<PNS::SEGMENT> seg( new PNS::SEGMENT( s, m_track->GetNetCode() ) );
+
+    seg->SetWidth( Millimeter2iu( 0.25 ) );
+    seg->SetLayer( F_Cu );
+    branch->Add( std::move( seg ) );
+
+    m_router.CommitRouting( branch );
+
+    BOOST_CHECK_EQUAL( m_board.Tracks().size(), 2u );
+    BOOST_CHECK_EQUAL( WorldNetItemCount(), 2u );
+
+    m_router.UpdateWorld();
+
+    BOOST_CHECK_EQUAL( WorldNetItemCount(), 2u );
+}
+
+
+/**
+ * A track modified, then removed before the world is updated.
+ */
+BOOST_AUTO_TEST_CASE( TrackModifiedThenRemoved )
+{
+    EditTrack();
+    m_board.ChangeLog().Record( m_track, BOARD_CHANGE_LOG::MODIFIED );
+    m_board.Remove( m_track );
+
+    m_router.UpdateWorld();
+
+    BOOST_CHECK( !m_router.GetWorld()->FindItemByParent( m_track ) );
+    BOOST_CHECK_EQUAL( WorldNetItemCount(), 0u );
+
+    delete m_track;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
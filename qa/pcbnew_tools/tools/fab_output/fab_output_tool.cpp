@@ -0,0 +1,234 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file fab_output_tool.cpp
+ * Creates the fabrication files of PCB files (layer plots, drill files, Gerber job file and
+ * placement files) with FAB_OUTPUT_JOB, from the command line and without the editor, and
+ * reports the time taken.
+ */
+
+#include <cstdio>
+
+#include <common.h>
+#include <profile.h>
+#include <reporter.h>
+
+#include <wx/cmdline.h>
+#include <wx/tokenzr.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+
+#include <exporters/fab_output_job.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "output directory (default: the directory of the board plot settings)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "l",
+            "layers",
+            _( "comma separated names of the layers to plot (default: the layers of the "
+               "board plot settings)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "d",
+            "drill",
+            _( "drill file format: excellon (default), gerber or none" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "p",
+            "placement",
+            _( "placement file format: none (default), ascii, csv or gerber" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "threads",
+            _( "number of threads (default: all the cores)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum FAB_OUTPUT_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    BAD_LAYER,
+    OUTPUT_FAILED,
+};
+
+
+int fab_output_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program creates the fabrication files of PCB files, using the plot "
+               "settings stored in the boards." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString outputDir, layers;
+    wxString drill = "excellon";
+    wxString placement = "none";
+    long     threads = 0;
+
+    cl_parser.Found( "output", &outputDir );
+    cl_parser.Found( "layers", &layers );
+    cl_parser.Found( "drill", &drill );
+    cl_parser.Found( "placement", &placement );
+    cl_parser.Found( "threads", &threads );
+
+    FAB_OUTPUT_JOB::DRILL_FORMAT drillFormat;
+
+    if( drill == "excellon" )
+        drillFormat = FAB_OUTPUT_JOB::EXCELLON_DRILL_FILES;
+    else if( drill == "gerber" )
+        drillFormat = FAB_OUTPUT_JOB::GERBER_DRILL_FILES;
+    else if( drill == "none" )
+        drillFormat = FAB_OUTPUT_JOB::NO_DRILL_FILES;
+    else
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    FAB_OUTPUT_JOB::PLACEMENT_FORMAT placementFormat;
+
+    if( placement == "none" )
+        placementFormat = FAB_OUTPUT_JOB::NO_PLACEMENT_FILES;
+    else if( placement == "ascii" )
+        placementFormat = FAB_OUTPUT_JOB::ASCII_PLACEMENT_FILES;
+    else if( placement == "csv" )
+        placementFormat = FAB_OUTPUT_JOB::CSV_PLACEMENT_FILES;
+    else if( placement == "gerber" )
+        placementFormat = FAB_OUTPUT_JOB::GERBER_PLACEMENT_FILES;
+    else
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    int ret = KI_TEST::RET_CODES::OK;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        const std::string filename = cl_parser.GetParam( i ).ToStdString();
+
+        std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+        if( !board )
+            return FAB_OUTPUT_RET_CODES::LOAD_FAILED;
+
+        // The output paths are built from the board file name
+        board->SetFileName( cl_parser.GetParam( i ) );
+
+        FAB_OUTPUT_JOB job( board.get() );
+
+        if( !outputDir.IsEmpty() )
+            job.GetPlotOptions().SetOutputDirectory( outputDir );
+
+        if( !layers.IsEmpty() )
+        {
+            job.SetLayers( LSET() );
+
+            wxStringTokenizer tokenizer( layers, "," );
+
+            while( tokenizer.HasMoreTokens() )
+            {
+                wxString     name = tokenizer.GetNextToken().Trim().Trim( false );
+                PCB_LAYER_ID layer = board->GetLayerID( name );
+
+                if( layer == UNDEFINED_LAYER )
+                {
+                    printf( "%s: unknown layer %s\n", filename.c_str(),
+                            name.ToStdString().c_str() );
+                    return FAB_OUTPUT_RET_CODES::BAD_LAYER;
+                }
+
+                job.AddLayer( layer );
+            }
+        }
+
+        job.SetDrillFormat( drillFormat );
+        job.SetPlacementFormat( placementFormat );
+        job.SetThreadCount( threads );
+
+        PROF_COUNTER timer;
+        bool         ok = job.Run( &STDOUT_REPORTER::GetInstance() );
+
+        timer.Stop();
+
+        printf( "%s: %d files in %.1f ms\n", filename.c_str(), (int) job.GetOutputFiles().size(),
+                timer.msecs() );
+
+        if( !ok )
+            ret = FAB_OUTPUT_RET_CODES::OUTPUT_FAILED;
+    }
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "fab_output",
+        "Create the fabrication files of PCB files",
+        fab_output_main_func,
+} );
@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_index_tool.cpp
+ * Benchmarks the spatial index of the interactive router on a board: the time to copy the
+ * board into the router world, and the time to find the obstacles of every board item,
+ * with the board items in the dynamic R-trees and in the packed R-trees.
+ */
+
+#include <cstdio>
+#include <set>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <pcbnew_utils/pns_headless_iface.h>
+
+#include <class_board.h>
+
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+struct INDEX_BENCH_RESULT
+{
+    double m_syncTime = 0.0;     ///< in ms
+    double m_queryTime = 0.0;    ///< in ms
+    size_t m_items = 0;
+    size_t m_obstacles = 0;
+};
+
+
+static INDEX_BENCH_RESULT benchmark( BOARD& aBoard, bool aPacked, int aRepeat )
+{
+    INDEX_BENCH_RESULT                result;
+    KI_TEST::PNS_KICAD_IFACE_HEADLESS iface;
+    PNS::ROUTER                       router;
+    PNS::NODE                         world;
+
+    iface.SetBoard( &aBoard );
+    router.SetInterface( &iface );
+
+    PROF_COUNTER syncTimer;
+
+    if( aPacked )
+        world.BeginBulkLoad();
+
+    iface.SyncWorld( &world );
+
+    if( aPacked )
+        world.EndBulkLoad();
+
+    syncTimer.Stop();
+    result.m_syncTime = syncTimer.msecs();
+
+    std::set<PNS::ITEM*> items;
+
+    for( unsigned net = 0; net < aBoard.GetNetCount(); net++ )
+        world.AllItemsInNet( net, items );
+
+    result.m_items = items.size();
+
+    PROF_COUNTER queryTimer;
+
+    for( int i = 0; i < aRepeat; i++ )
+    {
+        for( PNS::ITEM* item : items )
+        {
+            PNS::NODE::OBSTACLES obstacles;
+
+            result.m_obstacles += world.QueryColliding( item, obstacles );
+        }
+    }
+
+    queryTimer.Stop();
+    result.m_queryTime = queryTimer.msecs();
+
+    return result;
+}
+
+
+static void reportResult( const char* aIndexName, const INDEX_BENCH_RESULT& aResult )
+{
+    printf( "%s: world sync %.3f ms, %zu item queries %.3f ms, %zu obstacles found\n",
+            aIndexName, aResult.m_syncTime, aResult.m_items, aResult.m_queryTime,
+            aResult.m_obstacles );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the items are queried" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum PNS_INDEX_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULTS_DIFFER,
+};
+
+
+int pns_index_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program copies PCB files into the interactive router world and queries "
+               "the obstacles of every item, with the dynamic and the packed spatial "
+               "indices." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    int ret = KI_TEST::RET_CODES::OK;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        const std::string filename = cl_parser.GetParam( i ).ToStdString();
+
+        std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+        if( !board )
+            return PNS_INDEX_RET_CODES::LOAD_FAILED;
+
+        printf( "%s\n", filename.c_str() );
+
+        INDEX_BENCH_RESULT dynamic = benchmark( *board, false, repeat );
+        reportResult( "    dynamic", dynamic );
+
+        INDEX_BENCH_RESULT packed = benchmark( *board, true, repeat );
+        reportResult( "    packed ", packed );
+
+        if( dynamic.m_obstacles != packed.m_obstacles )
+        {
+            printf( "    ERROR: the indices found different obstacles\n" );
+            ret = PNS_INDEX_RET_CODES::RESULTS_DIFFER;
+        }
+    }
+
+    return ret;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_index",
+        "Benchmark the interactive router spatial index on PCB files",
+        pns_index_main_func,
+} );
@@ -0,0 +1,371 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_replay_tool.cpp
+ * Replays recorded interactive router events on a board, without a frame or a view,
+ * and reports the latency of each router move.
+ *
+ * The events are the "event" lines saved by PNS::ROUTER::DumpLog() in
+ * /tmp/pns_events.log (other lines are ignored).  The router only records them
+ * in debug builds, see PNS::ROUTER::EnableEventLog():
+ *
+ *     event start <x> <y> <layer>
+ *     event move <x> <y> 0
+ *     event fix <x> <y> <force finish>
+ *
+ * Several recordings can be concatenated to replay several routes.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <pcbnew_utils/pns_headless_iface.h>
+
+#include <class_board.h>
+
+#include <router/pns_router.h>
+#include <router/pns_sizes_settings.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+struct REPLAY_EVENT
+{
+    enum TYPE
+    {
+        START,
+        MOVE,
+        FIX
+    };
+
+    TYPE     m_type;
+    VECTOR2I m_pos;
+    int      m_arg;
+};
+
+
+/**
+ * Read the router events of \a aFilename.
+ * @return false if the file cannot be read.
+ */
+static bool readEvents( const std::string& aFilename, std::vector<REPLAY_EVENT>& aEvents )
+{
+    std::ifstream file( aFilename );
+
+    if( !file )
+        return false;
+
+    std::string line;
+
+    while( std::getline( file, line ) )
+    {
+        std::istringstream tokens( line );
+        std::string        keyword, name;
+        REPLAY_EVENT       event;
+
+        if( !( tokens >> keyword >> name >> event.m_pos.x >> event.m_pos.y >> event.m_arg )
+            || keyword != "event" )
+            continue;
+
+        if( name == "start" )
+            event.m_type = REPLAY_EVENT::START;
+        else if( name == "move" )
+            event.m_type = REPLAY_EVENT::MOVE;
+        else if( name == "fix" )
+            event.m_type = REPLAY_EVENT::FIX;
+        else
+            continue;
+
+        aEvents.push_back( event );
+    }
+
+    return true;
+}
+
+
+/**
+ * Pick the item routing starts from, preferring pads and vias to tracks as the router
+ * tool does.
+ */
+static PNS::ITEM* pickStartItem( PNS::ROUTER& aRouter, const VECTOR2I& aP, int aLayer )
+{
+    PNS::ITEM_SET candidates = aRouter.QueryHoverItems( aP );
+    PNS::ITEM*    best = nullptr;
+
+    for( PNS::ITEM* item : candidates.Items() )
+    {
+        if( !item->IsRoutable() || !item->Layers().Overlaps( aLayer ) )
+            continue;
+
+        if( !best || item->OfKind( PNS::ITEM::SOLID_T | PNS::ITEM::VIA_T ) )
+            best = item;
+    }
+
+    return best;
+}
+
+
+/**
+ * The statistics of the replay of the events in a given router mode.
+ */
+struct REPLAY_RESULT
+{
+    std::vector<double> m_moveTimes;    ///< in ms
+    int                 m_failedStarts = 0;
+    int                 m_fixedRoutes = 0;
+};
+
+
+static REPLAY_RESULT replay( BOARD& aBoard, const std::vector<REPLAY_EVENT>& aEvents,
+                             PNS::ROUTER_MODE aMode, PNS::PNS_MODE aRoutingMode, bool aParallel )
+{
+    REPLAY_RESULT                     result;
+    KI_TEST::PNS_KICAD_IFACE_HEADLESS iface;
+    PNS::ROUTER                       router;
+
+    iface.SetBoard( &aBoard );
+    router.SetInterface( &iface );
+    router.SyncWorld();
+    router.SetMode( aMode );
+    router.Settings().SetMode( aRoutingMode );
+    router.Settings().SetParallelCandidates( aParallel );
+
+    bool routing = false;
+
+    for( const REPLAY_EVENT& event : aEvents )
+    {
+        switch( event.m_type )
+        {
+        case REPLAY_EVENT::START:
+        {
+            if( router.RoutingInProgress() )
+                router.StopRouting();
+
+            PNS::ITEM*          startItem = pickStartItem( router, event.m_pos, event.m_arg );
+            PNS::SIZES_SETTINGS sizes;
+
+            sizes.Init( &aBoard, startItem );
+            router.UpdateSizes( sizes );
+
+            routing = router.StartRouting( event.m_pos, startItem, event.m_arg );
+
+            if( !routing )
+                result.m_failedStarts++;
+
+            break;
+        }
+
+        case REPLAY_EVENT::MOVE:
+        {
+            if( !routing )
+                break;
+
+            PROF_COUNTER timer;
+
+            router.Move( event.m_pos, nullptr );
+
+            timer.Stop();
+            result.m_moveTimes.push_back( timer.msecs() );
+            break;
+        }
+
+        case REPLAY_EVENT::FIX:
+            if( routing && router.FixRoute( event.m_pos, nullptr, event.m_arg != 0 ) )
+            {
+                result.m_fixedRoutes++;
+                routing = false;
+            }
+
+            break;
+        }
+    }
+
+    if( router.RoutingInProgress() )
+        router.StopRouting();
+
+    return result;
+}
+
+
+static double percentile( const std::vector<double>& aSorted, double aPercent )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    size_t index = (size_t)( aPercent / 100.0 * ( aSorted.size() - 1 ) + 0.5 );
+
+    return aSorted[ std::min( index, aSorted.size() - 1 ) ];
+}
+
+
+static void reportResult( const std::string& aModeName, REPLAY_RESULT& aResult )
+{
+    std::vector<double>& times = aResult.m_moveTimes;
+
+    std::sort( times.begin(), times.end() );
+
+    printf( "%s: %zu moves, %d routes fixed, %d failed starts\n", aModeName.c_str(),
+            times.size(), aResult.m_fixedRoutes, aResult.m_failedStarts );
+    printf( "    move latency p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            percentile( times, 50 ), percentile( times, 90 ), percentile( times, 99 ),
+            times.empty() ? 0.0 : times.back() );
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "w",
+            "walkaround",
+            _( "replay in walkaround mode" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "s",
+            "shove",
+            _( "replay in shove mode" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "d",
+            "diff-pair",
+            _( "replay as differential pair routing (shove mode)" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "p",
+            "parallel",
+            _( "evaluate walkaround and optimizer candidates on worker threads" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "router events file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int pns_replay_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program replays interactive router events on a PCB file and reports "
+               "the router latency. If no mode is given, all modes are replayed." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> board =
+            KI_TEST::ReadBoardFromFileOrStream( cl_parser.GetParam( 0 ).ToStdString() );
+
+    if( !board )
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+
+    std::vector<REPLAY_EVENT> events;
+
+    if( !readEvents( cl_parser.GetParam( 1 ).ToStdString(), events ) )
+    {
+        fprintf( stderr, "Cannot read router events from %s\n",
+                 (const char*) cl_parser.GetParam( 1 ).mb_str() );
+        return PNS_REPLAY_RET_CODES::LOAD_FAILED;
+    }
+
+    bool parallel = cl_parser.Found( "parallel" );
+    bool all = !cl_parser.Found( "walkaround" ) && !cl_parser.Found( "shove" )
+               && !cl_parser.Found( "diff-pair" );
+
+    if( all || cl_parser.Found( "walkaround" ) )
+    {
+        REPLAY_RESULT result =
+                replay( *board, events, PNS::PNS_MODE_ROUTE_SINGLE, PNS::RM_Walkaround, parallel );
+        reportResult( "walkaround", result );
+    }
+
+    if( all || cl_parser.Found( "shove" ) )
+    {
+        REPLAY_RESULT result =
+                replay( *board, events, PNS::PNS_MODE_ROUTE_SINGLE, PNS::RM_Shove, parallel );
+        reportResult( "shove", result );
+    }
+
+    if( all || cl_parser.Found( "diff-pair" ) )
+    {
+        REPLAY_RESULT result =
+                replay( *board, events, PNS::PNS_MODE_ROUTE_DIFF_PAIR, PNS::RM_Shove, parallel );
+        reportResult( "diff-pair", result );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_replay",
+        "Replay interactive router events on a PCB and report the router latency",
+        pns_replay_main_func,
+} );
@@ -0,0 +1,251 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file spread_footprints_tool.cpp
+ * Benchmarks SpreadFootprints(), which separates the footprints stacked at the same place
+ * after reading a netlist: on generated footprints of random sizes spread over a number of
+ * schematic sheets, or on the footprints of PCB files. Checks the spread footprints do not
+ * overlap.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+
+#include <autorouter/spread_footprints.h>
+
+#include <qa_utils/utility_registry.h>
+
+
+/**
+ * Add to aBoard aCount footprints made of a single rectangular pad of random size, all at
+ * the origin, spread over aSheets schematic sheets.
+ */
+static void generateFootprints( BOARD& aBoard, int aCount, int aSheets )
+{
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> sizeDist( Millimeter2iu( 0.5 ), Millimeter2iu( 10 ) );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        MODULE* footprint = new MODULE( &aBoard );
+        D_PAD*  pad = new D_PAD( footprint );
+
+        pad->SetShape( PAD_SHAPE_RECT );
+        pad->SetSize( wxSize( sizeDist( rng ), sizeDist( rng ) ) );
+        footprint->Add( pad );
+
+        footprint->SetPath( wxString::Format( "/%08X/%08X", i % aSheets, i ) );
+        aBoard.Add( footprint );
+    }
+}
+
+
+/**
+ * @return the number of pairs of footprints of aFootprints whose rectangles overlap.
+ */
+static int countOverlaps( const std::vector<MODULE*>& aFootprints )
+{
+    std::vector<EDA_RECT> rects;
+
+    for( MODULE* footprint : aFootprints )
+        rects.push_back( footprint->GetFootprintRect() );
+
+    std::sort( rects.begin(), rects.end(),
+            []( const EDA_RECT& a, const EDA_RECT& b )
+            {
+                return a.GetX() < b.GetX();
+            } );
+
+    int overlaps = 0;
+
+    for( size_t i = 0; i < rects.size(); i++ )
+    {
+        for( size_t j = i + 1; j < rects.size() && rects[j].GetX() < rects[i].GetRight(); j++ )
+        {
+            if( rects[j].GetY() < rects[i].GetBottom() && rects[i].GetY() < rects[j].GetBottom() )
+                overlaps++;
+        }
+    }
+
+    return overlaps;
+}
+
+
+/**
+ * Spread the footprints of aBoard and report the time taken and the spread area.
+ * @return the number of overlapping footprints found after spreading.
+ */
+static int benchmark( BOARD& aBoard )
+{
+    std::vector<MODULE*> footprints;
+
+    for( MODULE* footprint : aBoard.Modules() )
+        footprints.push_back( footprint );
+
+    PROF_COUNTER timer;
+
+    SpreadFootprints( &footprints, wxPoint( 0, 0 ) );
+
+    timer.Stop();
+
+    EDA_RECT area;
+    double   footprintArea = 0.0;
+
+    for( MODULE* footprint : footprints )
+    {
+        EDA_RECT rect = footprint->GetFootprintRect();
+
+        area.Merge( rect );
+        footprintArea += (double) rect.GetWidth() * rect.GetHeight();
+    }
+
+    int overlaps = countOverlaps( footprints );
+
+    printf( "    %zu footprints spread in %.3f ms\n", footprints.size(), timer.msecs() );
+    printf( "    area %.1f x %.1f mm, %.0f%% covered by footprints, %d overlaps\n",
+            area.GetWidth() / IU_PER_MM, area.GetHeight() / IU_PER_MM,
+            100.0 * footprintArea / std::max( 1.0, (double) area.GetWidth() * area.GetHeight() ),
+            overlaps );
+
+    return overlaps;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "count",
+            _( "number of generated footprints (default 10000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "sheets",
+            _( "number of schematic sheets of the generated footprints (default 20)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+/**
+ * Tool-specific return codes
+ */
+enum SPREAD_FOOTPRINTS_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    OVERLAPS_FOUND,
+};
+
+
+int spread_footprints_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program spreads the footprints of PCB files, or generated footprints if "
+               "no file is given, as after reading a netlist, and reports the time taken." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    int overlaps = 0;
+
+    if( cl_parser.GetParamCount() == 0 )
+    {
+        long count = 10000;
+        long sheets = 20;
+
+        cl_parser.Found( "count", &count );
+        cl_parser.Found( "sheets", &sheets );
+
+        BOARD board;
+
+        generateFootprints( board, count, std::max( 1L, sheets ) );
+
+        printf( "%ld generated footprints, %ld sheets\n", count, sheets );
+        overlaps += benchmark( board );
+    }
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        const std::string filename = cl_parser.GetParam( i ).ToStdString();
+
+        std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+        if( !board )
+            return SPREAD_FOOTPRINTS_RET_CODES::LOAD_FAILED;
+
+        printf( "%s\n", filename.c_str() );
+        overlaps += benchmark( *board );
+    }
+
+    if( overlaps )
+        return SPREAD_FOOTPRINTS_RET_CODES::OVERLAPS_FOUND;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "spread_footprints",
+        "Benchmark spreading the footprints of a PCB after reading a netlist",
+        spread_footprints_main_func,
+} );
@@ -0,0 +1,68 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef QA_PCBNEW_UTILS_PNS_HEADLESS_IFACE__H
+#define QA_PCBNEW_UTILS_PNS_HEADLESS_IFACE__H
+
+#include <router/pns_debug_decorator.h>
+#include <router/pns_kicad_iface.h>
+
+/**
+ * @file pns_headless_iface.h
+ * A router interface for QA programs running the router without a frame
+ */
+namespace KI_TEST
+{
+
+/**
+ * A router interface without a view or a board commit: the routed items stay in the
+ * router world, and nothing is displayed.
+ */
+class PNS_KICAD_IFACE_HEADLESS : public PNS_KICAD_IFACE
+{
+public:
+    void EraseView() override {}
+    bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) override { return true; }
+    bool IsItemVisible( const PNS::ITEM* aItem ) override { return true; }
+    void HideItem( PNS::ITEM* aItem ) override {}
+    void AddItem( PNS::ITEM* aItem ) override {}
+    void RemoveItem( PNS::ITEM* aItem ) override {}
+    void Commit() override {}
+
+    void DisplayItem( const PNS::ITEM* aItem, int aColor, int aClearance, bool aEdit ) override
+    {
+    }
+
+    PNS::DEBUG_DECORATOR* GetDebugDecorator() override
+    {
+        return &m_debugDecorator;
+    }
+
+private:
+    PNS::DEBUG_DECORATOR m_debugDecorator;
+};
+
+} // namespace KI_TEST
+
+#endif // QA_PCBNEW_UTILS_PNS_HEADLESS_IFACE__H
@@ -366,6 +366,40 @@ bool VRML_LAYER::AddVertex( int aContourID, double aXpos, double aYpos )
 }
 
 
+// appends copies of the contours of another layer; the vertices are added in
+// the order of each contour so the area (and hence the winding) is preserved
+bool VRML_LAYER::CopyContours( const VRML_LAYER& aSource )
+{
+    if( fix )
+    {
+        error = "CopyContours(): no more vertices may be added (Tesselate was previously executed)";
+        return false;
+    }
+
+    std::list<int>::const_iterator cbeg;
+    std::list<int>::const_iterator cend;
+    VERTEX_3D* vp;
+
+    for( size_t i = 0; i < aSource.contours.size(); ++i )
+    {
+        int contour = NewContour( aSource.pth[i] );
+
+        cbeg = aSource.contours[i]->begin();
+        cend = aSource.contours[i]->end();
+
+        while( cbeg != cend )
+        {
+            vp = aSource.vertices[ *cbeg++ ];
+
+            if( !AddVertex( contour, vp->x, vp->y ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 // ensure the winding of a contour with respect to the normal (0, 0, 1);
 // set 'hole' to true to ensure a hole (clockwise winding)
 bool VRML_LAYER::EnsureWinding( int aContourID, bool aHoleFlag )
@@ -217,6 +217,18 @@ public:
      */
     bool AddVertex( int aContourID, double aXpos, double aYpos );
 
+    /**
+     * Function CopyContours
+     * appends copies of all the contours of another layer. Since tesselation
+     * renumbers the vertices of the holes object, each layer which is tesselated
+     * concurrently with others must be given its own copy of the holes.
+     *
+     * @param aSource is the layer to copy the contours from
+     *
+     * @return bool: true if the contours were copied
+     */
+    bool CopyContours( const VRML_LAYER& aSource );
+
     /**
      * Function EnsureWinding
      * checks the winding of a contour and ensures that it is a hole or